@@ -4,7 +4,8 @@ CONFIG += ordered
 
 SUBDIRS =  src \
            tests \
-           tests/qml_tests
+           tests/qml_tests \
+           tests/benchmarks
 
 QMAKE_CXXFLAGS += -std=c++11
 
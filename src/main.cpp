@@ -22,11 +22,22 @@
 #include "pointy_slide_viewer.h"
 #include "slide_data.h"
 #include "slide_list_model.h"
+#include "slide_enums.h"
+#include "slide_image_cache.h"
+#include "slide_image_provider.h"
+#include "slide_thumbnailer.h"
+#include "slide_video_probe.h"
+#include "slide_residency.h"
+#include "slide_media_watcher.h"
+#include "pointy_slide_item.h"
+#include "pointy_incubation_controller.h"
+#include "pointy_startup_profile.h"
 #include "pointy_command.h"
 #include <qdebug.h>
 #include <qtextstream.h>
 #include <iostream>
 #include <qstring.h>
+#include <qurl.h>
 
 #include <qguiapplication.h>
 #include <qqmlengine.h>
@@ -40,6 +51,7 @@
 #include <QKeyEvent>
 #include <qfileinfo.h>
 #include <qdatetime.h>
+#include <qstandardpaths.h>
 
 
 void helpMessage(const char* execName, QTextStream& qout);
@@ -47,10 +59,17 @@ void printRaw(const pointy::SlideListModel& showModel, QTextStream& qout);
 
 int main(int argc, char* argv[])
 {
+    pointy::StartupProfile startupProfile;
+    startupProfile.begin("arguments");
 
     QTextStream qout(stdout, QIODevice::WriteOnly);
     bool rawPrint(false);
     bool setFullScreen(false);
+    bool useDeckCache(true);
+    bool lazyLoading(false);
+    int mediaBudget(0);
+    bool showNotes(false);
+    bool showGrid(false);
 
     if (argc > 1) {
         for (int i=1; i < argc; ++i) {
@@ -67,24 +86,89 @@ int main(int argc, char* argv[])
                      QString(argv[i]) == "--fullscreen") {
                 setFullScreen = true;
             }
+            else if (QString(argv[i]) == "--no-cache") {
+                useDeckCache = false;
+            }
+            else if (QString(argv[i]) == "--lazy") {
+                lazyLoading = true;
+            }
+            else if (QString(argv[i]) == "-n" ||
+                     QString(argv[i]) == "--notes") {
+                showNotes = true;
+            }
+            else if (QString(argv[i]) == "-g" ||
+                     QString(argv[i]) == "--grid") {
+                showGrid = true;
+            }
+            else if (QString(argv[i]) == "--startup-profile") {
+                startupProfile.setEnabled(true);
+            }
+            else if (QString(argv[i]) == "--media-budget" &&
+                     i + 1 < argc - 1) {
+                mediaBudget = QString(argv[++i]).toInt();
+            }
         }
+        startupProfile.end("arguments");
 
 
-
+        startupProfile.begin("application");
         QGuiApplication app(argc, argv);
+        qmlRegisterUncreatableType<pointy::SlideEnums>(
+                    "Pointy", 1, 0, "Slide",
+                    "Slide only provides enum values");
+        qmlRegisterType<pointy::SlideListModel>();
+        qmlRegisterType<pointy::PointySlideItem>("Pointy", 1, 0,
+                                                 "PointySlideItem");
+        startupProfile.end("application");
 
         std::cout << "Reading: " << argv[argc - 1] <<std::endl;
         QString fileName = argv[argc - 1];
         pointy::SlideListModel showModel;
-        showModel.readSlideFile(fileName);
+        if (useDeckCache) {
+            showModel.setDeckCacheDir(QStandardPaths::writableLocation(
+                                          QStandardPaths::CacheLocation) +
+                                      "/decks");
+        }
+        showModel.setLazyLoading(lazyLoading);
         if (rawPrint) {
+            showModel.readSlideFile(fileName);
             printRaw(showModel, qout);
             return 0;
-        }        
+        }
+        if (!QFileInfo(fileName).isReadable()) {
+            qFatal("Slide file can not be read");
+        }
+        // parsed on a worker thread while the view is set up
+        startupProfile.begin("slide file parse");
+        startupProfile.watchDeck(&showModel);
+        showModel.loadSlideFile(fileName);
+
+        // slide images are decoded on worker threads and cached; both
+        // must outlive the view
+        pointy::SlideImageCache slideImageCache(QDir::currentPath());
+        pointy::SlideImagePrefetcher slideImages(&slideImageCache, &showModel);
+        pointy::SlideResidency slideResidency(&showModel, &slideImageCache);
+        slideResidency.setBudget(mediaBudget * 1024);
+        slideImages.setResidency(&slideResidency);
+        pointy::SlideThumbnailer slideThumbnails(
+                    &showModel, &slideImageCache, QDir::currentPath(),
+                    QStandardPaths::writableLocation(
+                        QStandardPaths::CacheLocation) + "/thumbnails");
+        // videos are opened once up front for their first frame
+        pointy::SlideVideoProbe slideVideos(&showModel, QDir::currentPath());
+        // slides reload media that is replaced on disk
+        pointy::SlideMediaWatcher slideMedia(&showModel, &slideImageCache);
+        // command slides run their commands in the background
+        pointy::PointyCommand slideCommands;
+        slideCommands.setSlides(&showModel);
 
         //QtQuick2ApplicationViewer view;
         PointySlideViewer view;
 
+        // off-screen slides and grid cells are built between frames
+        pointy::PointyIncubationController incubator(&view);
+        view.engine()->setIncubationController(&incubator);
+
         // monitor slide source file for updates
         view.setFileMonitor(fileName);
         view.setPosition(0,0);
@@ -93,6 +177,17 @@ int main(int argc, char* argv[])
         QQmlContext* context = view.rootContext();
         context->setContextProperty("slideShow", &showModel);
 
+        // the engine owns the provider
+        view.engine()->addImageProvider(
+                    "slides", new pointy::SlideImageProvider(&slideImageCache));
+        context->setContextProperty("slideImages", &slideImages);
+        context->setContextProperty("slideThumbnails", &slideThumbnails);
+        view.engine()->addImageProvider(
+                    "posters", new pointy::VideoPosterProvider(&slideVideos));
+        context->setContextProperty("slideVideos", &slideVideos);
+        context->setContextProperty("slideResidency", &slideResidency);
+        context->setContextProperty("slideCommands", &slideCommands);
+
         // To allow Qt Quick component access to the application's
         // working directory
         QString workingDir = QDir::currentPath();
@@ -107,7 +202,14 @@ int main(int argc, char* argv[])
                                                            workingDir + "/")));
         context->setContextProperty("currentPath", &(*currentPath));
 
-        view.setMainQmlFile("src/qml/SlideView.qml");
+        // the QML is built into the binary, and precompiled where the Qt
+        // Quick Compiler is available
+        startupProfile.begin("QML compile");
+        view.setSource(QUrl("qrc:/qml/SlideView.qml"));
+        startupProfile.end("QML compile");
+
+        startupProfile.begin("first frame");
+        startupProfile.watchFrames(&view);
         //view.showFullScreen();
         view.showExpanded();
 
@@ -116,6 +218,9 @@ int main(int argc, char* argv[])
         }
 
         QObject *rootObject = qobject_cast<QObject*>(view.rootObject());
+        // the other windows are only built when asked for
+        rootObject->setProperty("notesVisible", showNotes);
+        rootObject->setProperty("gridVisible", showGrid);
         QObject::connect(rootObject, SIGNAL(toggleScreenMode()),
                          &view, SLOT(toggleFullScreen()));
         QObject::connect(rootObject,SIGNAL(quitPointy()),
@@ -124,8 +229,6 @@ int main(int argc, char* argv[])
                          &view, SLOT(checkFileChanged()));
         QObject::connect(&view, SIGNAL(fileIsChanged()),
                          &showModel, SLOT(reloadSlides()));
-        QObject::connect(rootObject,SIGNAL(sendCommand(QString)),
-                         &view, SLOT(runCommand(QString)));
 
 
 
@@ -151,10 +254,23 @@ void helpMessage(const char* execName, QTextStream& qout)
                           "\nArguments:\n\n"
                           "\t-f, --fullscreen\t\t"
                           "Start presentation in fullscreen mode\n"
+                          "\t-g, --grid\t\t\tOpen the grid window\n"
                           "\t-h, --help\t\t\tPrint this message, then exit\n"
+                          "\t--lazy\t\t\t\t"
+                          "Parse slides as they are shown, for very "
+                          "large files\n"
+                          "\t--media-budget MiB\t\t"
+                          "Memory for decoded images and videos, "
+                          "default 512\n"
+                          "\t-n, --notes\t\t\tOpen the notes window\n"
+                          "\t--no-cache\t\t\t"
+                          "Always parse the slide file, skipping the "
+                          "deck cache\n"
                           "\t-r, --raw\t\t\t"
                           "Write raw slides to stdout,"
-                          " then exit"
+                          " then exit\n"
+                          "\t--startup-profile\t\t"
+                          "Print how long each phase of startup took\n"
                           "\n\nPresentation Controls:\n\n"
                           "\tSpacebar\t\t\tNext Slide\n"
                           "\tBackspace\t\t\tPrevious Slide\n"
@@ -164,6 +280,7 @@ void helpMessage(const char* execName, QTextStream& qout)
                           "\tn\t\t\t\tToggle Notes Window\n"
                           "\tReturn\t\t\t\tPlay Media\n"
                           "\t<, >\t\t\t\tSeek backwards/forwards\n"
+                          "\tm\t\t\t\tPrint media residency\n"
             ).arg(execName);
     qout << msg << endl << endl;
 }
@@ -0,0 +1,219 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "pin_tokenizer.h"
+#include <QMessageLogger>
+#include <cstring>
+
+namespace pointy {
+
+namespace {
+
+const char* findByte(const char* from, const char* to, char byte)
+{
+    if (from >= to) {
+        return 0;
+    }
+    return static_cast<const char*>(memchr(from, byte, to - from));
+}
+
+int countByte(const char* from, const char* to, char byte)
+{
+    int count = 0;
+    while ((from = findByte(from, to, byte)) != 0) {
+        ++count;
+        ++from;
+    }
+    return count;
+}
+
+}   // namespace
+
+QByteArray PinToken::toByteArray() const
+{
+    QByteArray result(begin, length);
+    if (hasEscape) {
+        result.replace("\\#", "#");
+    }
+    return result;
+}
+
+QString PinToken::toString() const
+{
+    if (hasEscape) {
+        return QString::fromUtf8(toByteArray());
+    }
+    return QString::fromUtf8(begin, length);
+}
+
+PinTokenizer::PinTokenizer(const char* data, int size, bool inHeader,
+                           int firstLine):
+    cursor(data), end(data + size), lineBegin(data), lineEnd(data),
+    contentEnd(data), stage(LineStart), inHeader(inHeader),
+    lineCount(firstLine), openBrackets(0), closeBrackets(0)
+{}
+
+bool PinTokenizer::next(PinToken& token)
+{
+    forever {
+        switch (stage) {
+        case LineStart:
+            if (cursor >= end) {
+                return false;
+            }
+            beginLine();
+            if (stage == LineStart) {
+                continue;       // "#!" line skipped
+            }
+            if (stage == Settings && lineBegin[0] == '-') {
+                setToken(token, PinToken::SlideStart, lineBegin, lineEnd);
+                return true;
+            }
+            continue;
+        case Settings:
+            if (nextSetting(token)) {
+                return true;
+            }
+            stage = CommentText;
+            continue;
+        case TextSegments:
+            if (nextText(token)) {
+                return true;
+            }
+            stage = CommentText;
+            continue;
+        case CommentText:
+            stage = LineFinish;
+            if (contentEnd < lineEnd) {
+                setToken(token, PinToken::Comment, contentEnd + 1, lineEnd);
+                return true;
+            }
+            continue;
+        case LineFinish:
+            setToken(token, PinToken::LineEnd, lineBegin, lineEnd);
+            ++lineCount;
+            cursor = lineEnd;
+            stage = LineStart;
+            return true;
+        }
+    }
+}
+
+void PinTokenizer::beginLine()
+{
+    lineBegin = cursor;
+    const char* newline = findByte(cursor, end, '\n');
+    lineEnd = newline ? newline + 1 : end;
+    int lineLength = lineEnd - lineBegin;
+
+    if (lineCount == 0 && lineLength >= 2 &&
+            lineBegin[0] == '#' && lineBegin[1] == '!') {
+        cursor = lineEnd;
+        return;
+    }
+
+    // a '#' ends the line content unless it is escaped as "\#"
+    contentEnd = lineBegin;
+    while ((contentEnd = findByte(contentEnd, lineEnd, '#')) != 0) {
+        if (contentEnd == lineBegin || contentEnd[-1] != '\\') {
+            break;
+        }
+        ++contentEnd;
+    }
+    if (!contentEnd) {
+        contentEnd = lineEnd;
+    }
+
+    if (lineLength >= 2 && lineBegin[0] == '-' && lineBegin[1] == '-') {
+        inHeader = false;
+        stage = Settings;
+    }
+    else if (inHeader && lineLength >= 1 && lineBegin[0] == '[') {
+        stage = Settings;
+    }
+    else {
+        stage = TextSegments;
+        return;
+    }
+    openBrackets = countByte(lineBegin, contentEnd, '[');
+    // a "--" line is only searched for settings if it holds a '['
+    closeBrackets = openBrackets ? countByte(lineBegin, contentEnd, ']') : 0;
+}
+
+bool PinTokenizer::nextSetting(PinToken& token)
+{
+    if (openBrackets == 0 && closeBrackets == 0) {
+        return false;
+    }
+    if (openBrackets != closeBrackets) {
+        qWarning("Line %d: incomplete brackets", lineCount);
+        openBrackets = closeBrackets = 0;
+        return false;
+    }
+    const char* startBracket = findByte(cursor, contentEnd, '[');
+    if (!startBracket) {
+        return false;
+    }
+    const char* endBracket = findByte(cursor, contentEnd, ']');
+    if (endBracket < startBracket) {
+        qWarning("Line %d: mismatched brackets", lineCount);
+        openBrackets = closeBrackets = 0;
+        return false;
+    }
+    setToken(token, PinToken::Setting, startBracket + 1, endBracket);
+    token.hasEscape = findByte(startBracket, endBracket, '#') != 0;
+
+    openBrackets -= countByte(cursor, endBracket, '[');
+    --closeBrackets;
+    cursor = endBracket + 1;
+    return true;
+}
+
+bool PinTokenizer::nextText(PinToken& token)
+{
+    // every '#' before contentEnd is escaped; drop its backslash by ending
+    // the segment early and starting the next one at the '#'.  Without a
+    // comment, contentEnd is lineEnd and the newline stays in the text.
+    while (cursor < contentEnd) {
+        const char* searchFrom = (*cursor == '#') ? cursor + 1 : cursor;
+        const char* escaped = findByte(searchFrom, contentEnd, '#');
+        const char* segmentEnd = escaped ? escaped - 1 : contentEnd;
+        const char* segmentBegin = cursor;
+        cursor = escaped ? escaped : contentEnd;
+        if (segmentEnd > segmentBegin) {
+            setToken(token, PinToken::Text, segmentBegin, segmentEnd);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PinTokenizer::setToken(PinToken& token, PinToken::Type type,
+                            const char* begin, const char* end) const
+{
+    token.type = type;
+    token.begin = begin;
+    token.length = end - begin;
+    token.lineNumber = lineCount;
+    token.hasEscape = false;
+}
+
+}   // namespace pointy
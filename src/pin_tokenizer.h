@@ -0,0 +1,94 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef PIN_TOKENIZER_H
+#define PIN_TOKENIZER_H
+
+#include <qbytearray.h>
+#include <qstring.h>
+
+namespace pointy {
+
+// A token is a view into the buffer handed to PinTokenizer; it is only
+// valid for as long as that buffer is.
+class PinToken
+{
+public:
+    enum Type {
+        SlideStart,     // a "--" line
+        Setting,        // contents of a [...] pair
+        Comment,        // text after an unescaped '#', up to end of line
+        Text,           // slide text, split wherever "\#" was unescaped
+        LineEnd
+    };
+
+    Type type;
+    const char* begin;
+    int length;
+    int lineNumber;
+    bool hasEscape;     // Setting only: contains "\#"
+
+    QByteArray toByteArray() const;
+    QString toString() const;
+};
+
+// Single pass tokenizer for .pin files.  Lines are scanned in place, so no
+// per-line buffers are allocated; the rules mirror stripComments() and
+// stripSquareBrackets().
+class PinTokenizer
+{
+public:
+    PinTokenizer(const char* data, int size, bool inHeader = true,
+                 int firstLine = 0);
+
+    bool next(PinToken& token);
+
+private:
+    enum Stage {
+        LineStart,
+        Settings,
+        TextSegments,
+        CommentText,
+        LineFinish
+    };
+
+    void beginLine();
+    bool nextSetting(PinToken& token);
+    bool nextText(PinToken& token);
+    void setToken(PinToken& token, PinToken::Type type,
+                  const char* begin, const char* end) const;
+
+    const char* cursor;
+    const char* end;
+    const char* lineBegin;
+    const char* lineEnd;
+    const char* contentEnd;     // first unescaped '#', or lineEnd
+    Stage stage;
+    bool inHeader;
+    int lineCount;
+    int openBrackets;           // unconsumed '[' and ']' on this line
+    int closeBrackets;
+};
+
+}   // namespace pointy
+
+#endif // PIN_TOKENIZER_H
@@ -20,32 +20,260 @@
  */
 
 #include "pointy_command.h"
-#include <qtextstream.h>
+#include "pointy_command_output.h"
 
 namespace pointy {
 
-PointyCommand::PointyCommand()
+namespace {
+
+// rows from first on move by count, as rows are inserted or removed
+template <typename T>
+void shiftRows(QHash<int, T>& rows, int first, int count)
+{
+    QHash<int, T> shifted;
+    typename QHash<int, T>::const_iterator it = rows.constBegin();
+    for (; it != rows.constEnd(); ++it) {
+        int row = it.key();
+        shifted.insert(row >= first ? row + count : row, it.value());
+    }
+    rows = shifted;
+}
+
+// rows [first, last] move to before row to, as rowsMoved() reports it;
+// the rows they pass move the other way to make room
+template <typename T>
+void moveRows(QHash<int, T>& rows, int first, int last, int to)
+{
+    int count = last - first + 1;
+    QHash<int, T> moved;
+    typename QHash<int, T>::const_iterator it = rows.constBegin();
+    for (; it != rows.constEnd(); ++it) {
+        int row = it.key();
+        if (row >= first && row <= last) {
+            row += (to < first ? to : to - count) - first;
+        }
+        else if (to < first && row >= to && row < first) {
+            row += count;
+        }
+        else if (to > last && row > last && row < to) {
+            row -= count;
+        }
+        moved.insert(row, it.value());
+    }
+    rows = moved;
+}
+
+}   // namespace
+
+PointyCommand::PointyCommand(QObject* parent):
+    QObject(parent),
+    slides(0)
+{}
+
+PointyCommand::~PointyCommand()
+{
+    QList<int> running = processes.keys();
+    for (int i = 0; i < running.size(); ++i) {
+        stopCommand(running.at(i));
+    }
+}
+
+bool PointyCommand::isPermitted(const QString& command)
 {
-    process = QSharedPointer<QProcess>(new QProcess);
+    return !(command.startsWith("sudo ") || command.startsWith("rm ") ||
+             command.startsWith("su "));
 }
 
-void PointyCommand::runCommand(const QString &command)
+void PointyCommand::setSlides(QAbstractItemModel* slides)
 {
-    if (command.startsWith("sudo ") || command.startsWith("rm ") ||
-            command.startsWith("su ")) {
-                QTextStream qout(stdout, QIODevice::WriteOnly);
-                qout << "Command: " << command << " is not permitted.";
-                return;
+    if (this->slides) {
+        this->slides->disconnect(this);
     }
+    this->slides = slides;
+    if (!slides) {
+        return;
+    }
+    connect(slides, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(slidesInserted(QModelIndex,int,int)));
+    connect(slides, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            this, SLOT(slidesRemoved(QModelIndex,int,int)));
+    connect(slides, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+            this, SLOT(slidesMoved(QModelIndex,int,int,QModelIndex,int)));
+    connect(slides, SIGNAL(modelReset()), this, SLOT(slidesReset()));
+}
+
+QObject* PointyCommand::output(int slide)
+{
+    return slideOutput(slide);
+}
+
+bool PointyCommand::isRunning(int slide) const
+{
+    return processes.contains(slide);
+}
+
+void PointyCommand::runCommand(int slide, const QString& command)
+{
+    stopCommand(slide);
+    CommandOutput* output = slideOutput(slide);
+    output->clear();
+    if (!isPermitted(command)) {
+        qWarning("Command: %s is not permitted.", qPrintable(command));
+        output->appendLine("Command is not permitted.", true);
+        return;
+    }
+
+    QProcess* process = new QProcess(this);
+    connect(process, SIGNAL(readyReadStandardOutput()),
+            this, SLOT(readStandardOutput()));
+    connect(process, SIGNAL(readyReadStandardError()),
+            this, SLOT(readStandardError()));
+    connect(process, SIGNAL(finished(int,QProcess::ExitStatus)),
+            this, SLOT(processFinished(int,QProcess::ExitStatus)));
+    connect(process, SIGNAL(error(QProcess::ProcessError)),
+            this, SLOT(processError(QProcess::ProcessError)));
+    processes.insert(slide, process);
     process->start(command);
-//        bool isSuccess = process->startDetached(command);
-//    if (!isSuccess) {
-//        QTextStream qout(stdout, QIODevice::WriteOnly);
-//        qout << "Command: " << command << " failed.";
-//    }
+    emit commandStarted(slide);
+}
 
+// the process is killed rather than waited for; its output so far stays
+void PointyCommand::stopCommand(int slide)
+{
+    QProcess* process = processes.take(slide);
+    if (!process) {
+        return;
+    }
+    process->disconnect(this);
+    process->kill();
+    process->deleteLater();
+    slideOutput(slide)->finish();
+}
 
+void PointyCommand::readStandardOutput()
+{
+    QProcess* process = qobject_cast<QProcess*>(sender());
+    int slide = processSlide(process);
+    if (slide != -1) {
+        slideOutput(slide)->append(process->readAllStandardOutput());
+    }
 }
 
+void PointyCommand::readStandardError()
+{
+    QProcess* process = qobject_cast<QProcess*>(sender());
+    int slide = processSlide(process);
+    if (slide != -1) {
+        slideOutput(slide)->append(process->readAllStandardError(), true);
+    }
+}
+
+void PointyCommand::processFinished(int exitCode,
+                                    QProcess::ExitStatus exitStatus)
+{
+    int slide = processSlide(qobject_cast<QProcess*>(sender()));
+    if (slide == -1) {
+        return;
+    }
+    CommandOutput* output = slideOutput(slide);
+    output->finish();
+    if (exitStatus == QProcess::CrashExit) {
+        output->appendLine("Command crashed.", true);
+    }
+    release(slide);
+    emit commandFinished(slide, exitCode);
+}
+
+// a process that failed to start never finishes
+void PointyCommand::processError(QProcess::ProcessError error)
+{
+    QProcess* process = qobject_cast<QProcess*>(sender());
+    int slide = processSlide(process);
+    if (slide == -1 || error != QProcess::FailedToStart) {
+        return;
+    }
+    slideOutput(slide)->appendLine(process->errorString(), true);
+    release(slide);
+    emit commandFinished(slide, -1);
+}
+
+void PointyCommand::slidesInserted(const QModelIndex& parent, int first,
+                                   int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    shiftRows(processes, first, last - first + 1);
+    shiftRows(outputs, first, last - first + 1);
+}
+
+void PointyCommand::slidesRemoved(const QModelIndex& parent, int first,
+                                  int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int slide = first; slide <= last; ++slide) {
+        drop(slide);
+    }
+    shiftRows(processes, last + 1, first - last - 1);
+    shiftRows(outputs, last + 1, first - last - 1);
+}
+
+void PointyCommand::slidesMoved(const QModelIndex& parent, int first,
+                                int last, const QModelIndex& destination,
+                                int row)
+{
+    if (parent.isValid() || destination.isValid()) {
+        return;
+    }
+    moveRows(processes, first, last, row);
+    moveRows(outputs, first, last, row);
+}
+
+// no slide keeps its row through a reset
+void PointyCommand::slidesReset()
+{
+    QList<int> slides = processes.keys() + outputs.keys();
+    for (int i = 0; i < slides.size(); ++i) {
+        drop(slides.at(i));
+    }
+}
+
+// outputs are parented to the executor, so QML does not take them over
+CommandOutput* PointyCommand::slideOutput(int slide)
+{
+    CommandOutput* output = outputs.value(slide);
+    if (!output) {
+        output = new CommandOutput(CommandOutput::defaultCapacity, this);
+        outputs.insert(slide, output);
+    }
+    return output;
+}
+
+int PointyCommand::processSlide(QProcess* process) const
+{
+    return processes.key(process, -1);
+}
+
+void PointyCommand::release(int slide)
+{
+    QProcess* process = processes.take(slide);
+    if (process) {
+        process->disconnect(this);
+        process->deleteLater();
+    }
+}
+
+// a removed slide's command is killed; a delegate still showing its
+// output lets go of it once it is deleted
+void PointyCommand::drop(int slide)
+{
+    stopCommand(slide);
+    CommandOutput* output = outputs.take(slide);
+    if (output) {
+        output->deleteLater();
+    }
+}
 
 } // namespace pointy
@@ -23,27 +23,70 @@
 #ifndef POINTY_COMMAND_H
 #define POINTY_COMMAND_H
 
-#include <qprocess.h>
-#include <qsharedpointer.h>
+#include <qabstractitemmodel.h>
+#include <qhash.h>
 #include <qobject.h>
+#include <qprocess.h>
+#include <qstring.h>
 
 namespace pointy {
 
+class CommandOutput;
 
-
+// Runs the commands of command slides, each in its own QProcess, so
+// several can run at once.  Output is read as it arrives, never waited
+// for, into the slide's CommandOutput.  Running a slide's command again
+// stops the one still running for it.  Both are kept by slide row and
+// follow their slide as rows of the watched slide model are inserted,
+// removed or moved; a removed slide's command is killed.
 class PointyCommand: public QObject
 {
     Q_OBJECT
 public:
-    PointyCommand();
+    explicit PointyCommand(QObject* parent = 0);
+    ~PointyCommand();
+
+    static bool isPermitted(const QString& command);
+
+    // rows of slides are tracked through this model's row signals
+    void setSlides(QAbstractItemModel* slides);
+
+    // a CommandOutput, kept for as long as the executor; never null
+    Q_INVOKABLE QObject* output(int slide);
+    Q_INVOKABLE bool isRunning(int slide) const;
 
 public slots:
-    void runCommand(const QString& command);
-    //void commandFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void runCommand(int slide, const QString& command);
+    void stopCommand(int slide);
 
+signals:
+    void commandStarted(int slide);
+    void commandFinished(int slide, int exitCode);
+
+private slots:
+    void readStandardOutput();
+    void readStandardError();
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void processError(QProcess::ProcessError error);
+
+    void slidesInserted(const QModelIndex& parent, int first, int last);
+    void slidesRemoved(const QModelIndex& parent, int first, int last);
+    void slidesMoved(const QModelIndex& parent, int first, int last,
+                     const QModelIndex& destination, int row);
+    void slidesReset();
 
 private:
-    QSharedPointer<QProcess> process;
+    Q_DISABLE_COPY(PointyCommand)
+
+    CommandOutput* slideOutput(int slide);
+    int processSlide(QProcess* process) const;
+    void release(int slide);
+    void drop(int slide);
+
+    QAbstractItemModel* slides;
+
+    QHash<int, QProcess*> processes;
+    QHash<int, CommandOutput*> outputs;
 };
 
 }  // namespace pointy
@@ -0,0 +1,159 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "pointy_command_output.h"
+
+namespace pointy {
+
+CommandOutput::CommandOutput(int capacity, QObject* parent):
+    QAbstractListModel(parent), capacity(qMax(1, capacity)), first(0),
+    size(0)
+{}
+
+int CommandOutput::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return size;
+}
+
+QVariant CommandOutput::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= size) {
+        return QVariant();
+    }
+    const Line& line = ring.at((first + index.row()) % capacity);
+    switch (role) {
+    case Qt::DisplayRole:
+    case LineRole:
+        return line.text;
+    case StandardErrorRole:
+        return line.standardError;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> CommandOutput::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[LineRole] = "line";
+    roles[StandardErrorRole] = "standardError";
+    return roles;
+}
+
+void CommandOutput::append(const QByteArray& output, bool standardError)
+{
+    QByteArray& pending = standardError ? pendingError : pendingOutput;
+    pending.append(output);
+    addLines(takeLines(pending, standardError, false));
+}
+
+void CommandOutput::appendLine(const QString& line, bool standardError)
+{
+    Line added = { line, standardError };
+    addLines(QList<Line>() << added);
+}
+
+void CommandOutput::finish()
+{
+    addLines(takeLines(pendingOutput, false, true));
+    addLines(takeLines(pendingError, true, true));
+}
+
+void CommandOutput::clear()
+{
+    beginResetModel();
+    ring.clear();
+    first = 0;
+    size = 0;
+    pendingOutput.clear();
+    pendingError.clear();
+    endResetModel();
+}
+
+// the oldest rows are removed in one batch, and the new ones inserted in
+// another, however many lines arrived at once
+void CommandOutput::addLines(QList<Line> added)
+{
+    if (added.isEmpty()) {
+        return;
+    }
+    if (added.size() > capacity) {
+        added = added.mid(added.size() - capacity);
+    }
+    const int overflow = size + added.size() - capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        first = (first + overflow) % capacity;
+        size -= overflow;
+        endRemoveRows();
+    }
+    // lines are written to consecutive slots, so the ring only grows
+    // until it first wraps around
+    beginInsertRows(QModelIndex(), size, size + added.size() - 1);
+    for (int i = 0; i < added.size(); ++i) {
+        const int slot = (first + size) % capacity;
+        if (slot == ring.size()) {
+            ring.append(added.at(i));
+        }
+        else {
+            ring[slot] = added.at(i);
+        }
+        ++size;
+    }
+    endInsertRows();
+}
+
+QList<CommandOutput::Line> CommandOutput::takeLines(QByteArray& pending,
+                                                    bool standardError,
+                                                    bool all)
+{
+    QList<Line> lines;
+    int begin = 0;
+    forever {
+        int end = pending.indexOf('\n', begin);
+        if (end == -1 || end - begin > maxLineLength) {
+            if (pending.size() - begin > maxLineLength) {
+                end = begin + maxLineLength;
+            }
+            else if (all && begin < pending.size()) {
+                end = pending.size();
+            }
+            else {
+                break;
+            }
+        }
+        QByteArray text = pending.mid(begin, end - begin);
+        if (text.endsWith('\r')) {
+            text.chop(1);
+        }
+        Line line = { QString::fromLocal8Bit(text), standardError };
+        lines.append(line);
+        begin = (end < pending.size() && pending.at(end) == '\n') ?
+                    end + 1 : end;
+    }
+    pending.remove(0, begin);
+    return lines;
+}
+
+}   // namespace pointy
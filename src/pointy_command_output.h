@@ -0,0 +1,89 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef POINTY_COMMAND_OUTPUT_H
+#define POINTY_COMMAND_OUTPUT_H
+
+#include <QAbstractListModel>
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qstring.h>
+#include <qvector.h>
+
+namespace pointy {
+
+// The lines a command has written, as a list model for the slide to show.
+// Lines are kept in a ring buffer of a fixed number of lines; once it is
+// full the oldest lines are removed as new ones arrive, so a chatty
+// command uses bounded memory.  Views are told of each batch of lines as
+// it is added, so output appears while the command runs.
+class CommandOutput: public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit CommandOutput(int capacity = defaultCapacity,
+                           QObject* parent = 0);
+
+    static const int defaultCapacity = 500;     // lines
+    static const int maxLineLength = 1000;      // longer lines are split
+
+    enum OutputRoles {
+        LineRole = Qt::UserRole + 1,
+        StandardErrorRole
+    };
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role) const;
+
+    // output as read from the process; a line without its newline yet is
+    // held back until the rest arrives, or until finish()
+    void append(const QByteArray& output, bool standardError = false);
+    void appendLine(const QString& line, bool standardError = false);
+    void finish();
+    void clear();
+
+private:
+    Q_DISABLE_COPY(CommandOutput)
+
+    struct Line
+    {
+        QString text;
+        bool standardError;
+    };
+
+    QHash<int, QByteArray> roleNames() const;
+    void addLines(QList<Line> added);
+    QList<Line> takeLines(QByteArray& pending, bool standardError,
+                          bool all);
+
+    int capacity;
+    QVector<Line> ring;
+    int first;                  // index in ring of row 0
+    int size;
+    QByteArray pendingOutput;
+    QByteArray pendingError;
+};
+
+}   // namespace pointy
+
+#endif // POINTY_COMMAND_OUTPUT_H
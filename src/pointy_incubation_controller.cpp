@@ -0,0 +1,67 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "pointy_incubation_controller.h"
+#include <QtQuick/qquickwindow.h>
+
+namespace pointy {
+
+// frameSwapped() may come from the render thread; incubation has to run on
+// the GUI thread, so it is queued
+PointyIncubationController::PointyIncubationController(QQuickWindow* window,
+                                                       int frameBudget):
+    window(window), frameBudget(frameBudget)
+{
+    connect(window, SIGNAL(frameSwapped()), this, SLOT(incubate()),
+            Qt::QueuedConnection);
+    fallback.setSingleShot(true);
+    fallback.setInterval(fallbackInterval);
+    connect(&fallback, SIGNAL(timeout()), this, SLOT(incubate()));
+}
+
+// a frame is asked for, so that incubation starts even when nothing on
+// screen is changing; the timer covers a window that draws no frame
+void PointyIncubationController::incubatingObjectCountChanged(int count)
+{
+    if (count > 0) {
+        window->update();
+        if (!fallback.isActive()) {
+            fallback.start();
+        }
+    }
+    else {
+        fallback.stop();
+    }
+}
+
+void PointyIncubationController::incubate()
+{
+    if (incubatingObjectCount() == 0) {
+        return;
+    }
+    incubateFor(frameBudget);
+    if (incubatingObjectCount() > 0) {
+        window->update();
+        fallback.start();
+    }
+}
+
+}   // namespace pointy
@@ -0,0 +1,65 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef POINTY_INCUBATION_CONTROLLER_H
+#define POINTY_INCUBATION_CONTROLLER_H
+
+#include <qobject.h>
+#include <qqmlincubator.h>
+#include <qtimer.h>
+
+class QQuickWindow;
+
+namespace pointy {
+
+// Builds asynchronously created QML objects (delegates in the views' cache
+// buffers, and asynchronous Loaders) a few milliseconds at a time, after
+// each frame of the presentation window, so building off-screen slides and
+// grid cells does not cost the main window frames.  While the window draws
+// no frames (it is hidden, minimised or obscured) a timer incubates
+// instead, so objects never wait on a frame that does not come.
+class PointyIncubationController: public QObject,
+                                  public QQmlIncubationController
+{
+    Q_OBJECT
+public:
+    explicit PointyIncubationController(QQuickWindow* window,
+                                        int frameBudget = defaultFrameBudget);
+
+    static const int defaultFrameBudget = 4;        // msec per frame
+    static const int fallbackInterval = 50;         // msec without a frame
+
+protected:
+    void incubatingObjectCountChanged(int count);
+
+private slots:
+    void incubate();
+
+private:
+    QQuickWindow* window;
+    int frameBudget;
+    QTimer fallback;
+};
+
+}   // namespace pointy
+
+#endif // POINTY_INCUBATION_CONTROLLER_H
@@ -0,0 +1,223 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "pointy_slide_item.h"
+#include "slide_text_box.h"
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgnode.h>
+#include <QtQuick/qsgsimplerectnode.h>
+#include <QtQuick/qsgsimpletexturenode.h>
+#include <qscopedpointer.h>
+
+namespace pointy {
+
+namespace {
+
+// shading under text; the node owns the text's texture
+class TextBoxNode: public QSGNode
+{
+public:
+    TextBoxNode():
+        opacity(new QSGOpacityNode), shading(new QSGSimpleRectNode),
+        text(new QSGSimpleTextureNode)
+    {
+        opacity->appendChildNode(shading);
+        appendChildNode(opacity);
+        text->setFiltering(QSGTexture::Linear);
+        appendChildNode(text);
+    }
+
+    void setTexture(QSGTexture* texture)
+    {
+        text->setTexture(texture);
+        this->texture.reset(texture);
+    }
+
+    QSGOpacityNode* opacity;
+    QSGSimpleRectNode* shading;
+    QSGSimpleTextureNode* text;
+
+private:
+    QScopedPointer<QSGTexture> texture;
+};
+
+}   // namespace
+
+PointySlideItem::PointySlideItem(QQuickItem* parent):
+    QQuickItem(parent), slideRow(-1), shadingOpacity(0),
+    textImageChanged(false)
+{
+    setFlag(ItemHasContents);
+}
+
+SlideListModel* PointySlideItem::slides() const
+{
+    return model;
+}
+
+void PointySlideItem::setSlides(SlideListModel* slides)
+{
+    if (slides == model) {
+        return;
+    }
+    if (model) {
+        disconnect(model, 0, this, 0);
+    }
+    model = slides;
+    if (model) {
+        connect(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+                this, SLOT(slideDataChanged(QModelIndex,QModelIndex)));
+        connect(model, SIGNAL(modelReset()), this, SLOT(relayout()));
+    }
+    relayout();
+    emit slidesChanged();
+}
+
+int PointySlideItem::row() const
+{
+    return slideRow;
+}
+
+void PointySlideItem::setRow(int row)
+{
+    if (row == slideRow) {
+        return;
+    }
+    slideRow = row;
+    relayout();
+    emit rowChanged();
+}
+
+void PointySlideItem::geometryChanged(const QRectF& newGeometry,
+                                      const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        relayout();
+    }
+}
+
+// the text is rendered again for a new window or screen; before Qt 5.6
+// items are not told of a new pixel ratio, so the window's screen is
+// followed instead
+void PointySlideItem::itemChange(ItemChange change,
+                                 const ItemChangeData& value)
+{
+    QQuickItem::itemChange(change, value);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+    if (change == ItemDevicePixelRatioHasChanged) {
+        relayout();
+    }
+#endif
+    if (change != ItemSceneChange) {
+        return;
+    }
+#if QT_VERSION < QT_VERSION_CHECK(5, 6, 0)
+    if (screenWindow) {
+        disconnect(screenWindow, SIGNAL(screenChanged(QScreen*)),
+                   this, SLOT(relayout()));
+    }
+    screenWindow = value.window;
+    if (screenWindow) {
+        connect(screenWindow, SIGNAL(screenChanged(QScreen*)),
+                this, SLOT(relayout()));
+    }
+#endif
+    relayout();
+}
+
+void PointySlideItem::slideDataChanged(const QModelIndex& topLeft,
+                                       const QModelIndex& bottomRight)
+{
+    if (slideRow >= topLeft.row() && slideRow <= bottomRight.row()) {
+        relayout();
+    }
+}
+
+// several changes in one frame are laid out once, before the frame
+void PointySlideItem::relayout()
+{
+    polish();
+}
+
+void PointySlideItem::updatePolish()
+{
+    shadingRect = QRectF();
+    textSize = QSizeF();
+    textImage = QImage();
+    textImageChanged = true;
+    update();
+    if (!model || slideRow < 0 || slideRow >= model->rowCount() ||
+            width() <= 0 || height() <= 0) {
+        return;
+    }
+    QSharedPointer<SlideData> slide = model->slideAt(slideRow);
+    const int fontPixels = model->data(model->index(slideRow),
+                                       SlideListModel::FittedFontSizeRole)
+            .toInt();
+    SlideTextBox box(*slide, QSizeF(width(), height()), fontPixels);
+    if (box.isEmpty()) {
+        return;
+    }
+    shadingRect = box.rect();
+    shadingColor = slide->style().shadingColor;
+    shadingOpacity = slide->style().shadingOpacity;
+    // whole pixels, so the text texture is not resampled
+    textPosition = box.textRect().topLeft().toPoint();
+    textImage = box.renderText(window() ? window()->devicePixelRatio()
+                                        : 1.0);
+    if (!textImage.isNull()) {
+        textSize = box.textRect().size();
+    }
+}
+
+QSGNode* PointySlideItem::updatePaintNode(QSGNode* oldNode,
+                                          UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data);
+    TextBoxNode* node = static_cast<TextBoxNode*>(oldNode);
+    if (shadingRect.isEmpty() || textSize.isEmpty()) {
+        delete node;
+        return 0;
+    }
+    // the scene graph may also drop the node, with its texture; the image
+    // has gone with the upload, so it is rendered again for a later frame.
+    // This runs on the render thread, so the relayout is queued.
+    if (!node && !textImageChanged) {
+        QMetaObject::invokeMethod(this, "relayout", Qt::QueuedConnection);
+        return 0;
+    }
+    if (!node) {
+        node = new TextBoxNode;
+    }
+    node->opacity->setOpacity(shadingOpacity);
+    node->shading->setRect(shadingRect);
+    node->shading->setColor(shadingColor);
+    if (textImageChanged) {
+        node->setTexture(window()->createTextureFromImage(textImage));
+        textImage = QImage();
+        textImageChanged = false;
+    }
+    node->text->setRect(QRectF(textPosition, textSize));
+    return node;
+}
+
+}   // namespace pointy
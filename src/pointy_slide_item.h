@@ -0,0 +1,93 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef POINTY_SLIDE_ITEM_H
+#define POINTY_SLIDE_ITEM_H
+
+#include "slide_list_model.h"
+#include <QtQuick/qquickitem.h>
+#include <QtQuick/qquickwindow.h>
+#include <qcolor.h>
+#include <qimage.h>
+#include <qpointer.h>
+#include <qrect.h>
+
+class QSGNode;
+
+namespace pointy {
+
+// Draws one slide's text and its shading straight into the scene graph.
+// The box is laid out in C++ by SlideTextBox, from the slide's settings
+// and the model's fitted font size, and the text is rendered to a texture,
+// at the window's device pixel ratio, only when the slide or the item's
+// size changes.  The rendered image is let go once it is uploaded.  This
+// replaces a QML Text and Rectangle placed by a dozen script bindings.
+class PointySlideItem: public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(pointy::SlideListModel* slides READ slides WRITE setSlides
+               NOTIFY slidesChanged)
+    Q_PROPERTY(int row READ row WRITE setRow NOTIFY rowChanged)
+public:
+    explicit PointySlideItem(QQuickItem* parent = 0);
+
+    SlideListModel* slides() const;
+    void setSlides(SlideListModel* slides);
+    int row() const;
+    void setRow(int row);
+
+signals:
+    void slidesChanged();
+    void rowChanged();
+
+protected:
+    void geometryChanged(const QRectF& newGeometry,
+                         const QRectF& oldGeometry);
+    void itemChange(ItemChange change, const ItemChangeData& value);
+    void updatePolish();
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data);
+
+private slots:
+    void slideDataChanged(const QModelIndex& topLeft,
+                          const QModelIndex& bottomRight);
+    void relayout();
+
+private:
+    QPointer<SlideListModel> model;
+    int slideRow;
+#if QT_VERSION < QT_VERSION_CHECK(5, 6, 0)
+    QPointer<QQuickWindow> screenWindow;    // followed to a new screen
+#endif
+
+    // written by updatePolish(), read by updatePaintNode()
+    QRectF shadingRect;
+    QColor shadingColor;
+    qreal shadingOpacity;
+    QPointF textPosition;
+    QSizeF textSize;
+    QImage textImage;           // null once it is uploaded
+    bool textImageChanged;
+};
+
+}   // namespace pointy
+
+#endif // POINTY_SLIDE_ITEM_H
@@ -25,7 +25,8 @@
 PointySlideViewer::PointySlideViewer(QWindow* parent) :
     QtQuick2ApplicationViewer(parent)
 {
-
+    connect(&fileWatcher, SIGNAL(fileChanged(QString)),
+            this, SIGNAL(fileIsChanged()));
 }
 
 PointySlideViewer::~PointySlideViewer()
@@ -34,22 +35,14 @@ PointySlideViewer::~PointySlideViewer()
 
 void PointySlideViewer::setFileMonitor(const QString &fileName)
 {
-    currentFileInfo = fileName;
-    fileLastModified = currentFileInfo.lastModified();
+    fileWatcher.addFile(fileName);
 }
 
+// the watcher normally reports changes by itself; this looks at the file's
+// size and time straight away, and any hash is taken in the background
 void PointySlideViewer::checkFileChanged()
 {
-    currentFileInfo.refresh();
-    QDateTime newFileCheck = currentFileInfo.lastModified();
-    if (newFileCheck != fileLastModified)
-    {
-        emit fileIsChanged();
-        fileLastModified = newFileCheck;
-    }
-    else {
-        return;
-    }
+    fileWatcher.checkFiles();
 }
 
 void PointySlideViewer::toggleFullScreen()
@@ -62,11 +55,6 @@ void PointySlideViewer::toggleFullScreen()
     }
 }
 
-void PointySlideViewer::runCommand(const QString &command) {
-    qDebug() << "Running:" << command;
-    pointyCommand.runCommand(command);
-}
-
 //void PointySlideViewer::keyPressEvent(QKeyEvent *event){
 //    switch(event->key()) {
 //    case Qt::Key_F:
@@ -24,10 +24,8 @@
 #define POINTY_SLIDE_VIEWER_H
 
 #include "qtquick2applicationviewer.h"
-#include "pointy_command.h"
+#include "slide_file_watcher.h"
 #include <QKeyEvent>
-#include <qdatetime.h>
-#include <qfileinfo.h>
 
 class PointySlideViewer: public QtQuick2ApplicationViewer
 {
@@ -35,21 +33,19 @@ class PointySlideViewer: public QtQuick2ApplicationViewer
 public:
     explicit PointySlideViewer(QWindow* parent = 0);
     virtual ~PointySlideViewer();
+    // fileIsChanged() is emitted when the contents of fileName change
     void setFileMonitor(const QString& fileName);
 
 
 public slots:
     void checkFileChanged();
     void toggleFullScreen();
-    void runCommand(const QString& command);
 
 signals:
     void fileIsChanged();
 
 private:
-    QFileInfo currentFileInfo;
-    QDateTime fileLastModified;
-    pointy::PointyCommand pointyCommand;
+    pointy::SlideFileWatcher fileWatcher;
 
     //void keyPressEvent(QKeyEvent *event);
 
@@ -0,0 +1,110 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "pointy_startup_profile.h"
+#include "slide_list_model.h"
+#include <QtQuick/qquickwindow.h>
+#include <qtextstream.h>
+
+namespace pointy {
+
+StartupProfile::StartupProfile(QObject* parent):
+    QObject(parent), enabled(false), deckLoaded(false), frameShown(false)
+{
+    clock.start();
+}
+
+void StartupProfile::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+}
+
+void StartupProfile::begin(const QString& phase)
+{
+    Phase started = { phase, clock.elapsed(), -1 };
+    phases.append(started);
+}
+
+void StartupProfile::end(const QString& phase)
+{
+    for (int i = phases.size() - 1; i >= 0; --i) {
+        if (phases.at(i).name == phase && phases.at(i).end == -1) {
+            phases[i].end = clock.elapsed();
+            return;
+        }
+    }
+}
+
+void StartupProfile::watchDeck(SlideListModel* model)
+{
+    connect(model, SIGNAL(slidesLoaded()), this, SLOT(slidesLoaded()));
+}
+
+// frameSwapped() may come from the render thread
+void StartupProfile::watchFrames(QQuickWindow* window)
+{
+    connect(window, SIGNAL(frameSwapped()), this, SLOT(frameSwapped()),
+            Qt::QueuedConnection);
+}
+
+void StartupProfile::slidesLoaded()
+{
+    if (deckLoaded) {
+        return;
+    }
+    deckLoaded = true;
+    end("slide file parse");
+    if (frameShown) {
+        print();
+    }
+}
+
+void StartupProfile::frameSwapped()
+{
+    if (frameShown) {
+        return;
+    }
+    frameShown = true;
+    end("first frame");
+    if (deckLoaded) {
+        print();
+    }
+}
+
+void StartupProfile::print() const
+{
+    if (!enabled) {
+        return;
+    }
+    QTextStream err(stderr, QIODevice::WriteOnly);
+    err << "Startup profile (msec):\n";
+    err << qSetFieldWidth(24) << left << "  phase" << qSetFieldWidth(10)
+        << right << "start" << "end" << "duration" << qSetFieldWidth(0)
+        << "\n";
+    for (int i = 0; i < phases.size(); ++i) {
+        const Phase& phase = phases.at(i);
+        err << qSetFieldWidth(24) << left << "  " + phase.name
+            << qSetFieldWidth(10) << right << phase.begin << phase.end
+            << phase.end - phase.begin << qSetFieldWidth(0) << "\n";
+    }
+}
+
+}   // namespace pointy
@@ -0,0 +1,79 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef POINTY_STARTUP_PROFILE_H
+#define POINTY_STARTUP_PROFILE_H
+
+#include <qelapsedtimer.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qstring.h>
+
+class QQuickWindow;
+
+namespace pointy {
+
+class SlideListModel;
+
+// Times the phases of startup for --startup-profile, from the start of
+// main() to the first frame on screen.  The slide file is parsed on a
+// worker thread while the view is set up, so that phase overlaps others.
+// The breakdown is printed once the deck is loaded and the first frame
+// has been shown.
+class StartupProfile: public QObject
+{
+    Q_OBJECT
+public:
+    explicit StartupProfile(QObject* parent = 0);
+
+    void setEnabled(bool enabled);
+    void begin(const QString& phase);
+    void end(const QString& phase);
+
+    // end "slide file parse" and "first frame" when they happen
+    void watchDeck(SlideListModel* model);
+    void watchFrames(QQuickWindow* window);
+
+private slots:
+    void slidesLoaded();
+    void frameSwapped();
+
+private:
+    struct Phase
+    {
+        QString name;
+        qint64 begin;
+        qint64 end;
+    };
+
+    void print() const;
+
+    QElapsedTimer clock;
+    QList<Phase> phases;
+    bool enabled;
+    bool deckLoaded;
+    bool frameShown;
+};
+
+}   // namespace pointy
+
+#endif // POINTY_STARTUP_PROFILE_H
@@ -22,6 +22,7 @@
 
 import QtQuick 2.0
 import QtMultimedia 5.0
+import Pointy 1.0
 
 Rectangle {
     id: slideElement;
@@ -32,26 +33,19 @@ Rectangle {
     property int slideWidth;
     property int slideHeight;
     property string pointyNotes: notesText;
-    property string pointyStageColor: stageColor;
-    property string pointyTransition: transitionType;
+    property color pointyStageColor: stageColor;
+    property int pointyTransition: transitionType;
     property double pointyOpacity: 1.0;
-    property string textPosition: position;
-    property string pointyTextAlign: textAlign;
+    property int textPosition: position;
+    property int pointyTextAlign: textAlign;
     property double scaleFactor: 1;
     property bool isMediaSlide: false;
     property bool isCommandSlide: false;
     property string commandOut;
 
-    property int scaleFont: {
-        if (0.5 * fontPixelSize * maxLineLength > slideWidth) {
-        //if (slideTextData.contentWidth > slideWidth) {
-            return 2 * slideWidth / maxLineLength;
-        }
-        else {
-            return fontPixelSize * scaleFactor;
-        }
-    }
-    property double padding: { scaleFont/2; }
+    // laid out by the model for the window size, so resizing does not
+    // measure every slide's text here
+    property int scaleFont: { fittedFontSize * scaleFactor; }
 
     width: slideWidth;
     height: slideHeight;
@@ -68,29 +62,26 @@ Rectangle {
 
             source: {
                 if (slideMedia != "") {
-                    return currentPath.currentDir + slideMedia;
+                    // decoded off the GUI thread, at the size shown; the
+                    // revision changes when the file is replaced.  The
+                    // name is encoded so '#', '?' and '%' stay in it
+                    return "image://slides/" + mediaRevision + "/" +
+                            encodeURIComponent(slideMedia);
                 }
                 else {
                     return "blank.png";
                 }
             }
-            fillMode: {
-                // fill|fit|stretch|unscaled
-                if (backgroundScale === "fit") {
-                    Image.PreserveAspectFit;
-                }
-                else if (backgroundScale === "fill") {
-                    Image.PreserveAspectCrop;
-                }
-                else if (backgroundScale === "stretch") {
-                    Image.Stretch;
-                }
-                else if (backgroundScale === "unscaled")
-                {
-                    Image.Pad;
-                }
-
+            asynchronous: true;
+            // an empty sourceSize keeps unscaled images at full size
+            sourceSize.width: {
+                (backgroundScale === Slide.Unscaled) ? 0 : slideElement.width;
+            }
+            sourceSize.height: {
+                (backgroundScale === Slide.Unscaled) ? 0 : slideElement.height;
             }
+            // Slide scale modes share their values with Image.fillMode
+            fillMode: backgroundScale;
 
         }
     }
@@ -101,6 +92,35 @@ Rectangle {
 
             Video {
                 id: video;
+                property int videoDuration: slideVideos.duration(slideMedia);
+
+                // the first frame, probed when the deck was loaded, until
+                // the video has been played
+                Image {
+                    id: poster;
+                    anchors.fill: parent;
+                    asynchronous: true;
+                    cache: false;
+                    source: slideVideos.posterUrl(slideMedia);
+                    fillMode: video.fillMode;
+                    visible: {
+                        video.playbackState === MediaPlayer.StoppedState ||
+                                video.position === 0;
+                    }
+
+                    Connections {
+                        target: slideVideos;
+                        onProbed: {
+                            if (media === slideMedia) {
+                                poster.source = "";
+                                poster.source =
+                                        slideVideos.posterUrl(slideMedia);
+                                video.videoDuration =
+                                        slideVideos.duration(slideMedia);
+                            }
+                        }
+                    }
+                }
 
                 Image {
                     id: playControl;
@@ -110,6 +130,24 @@ Rectangle {
                     anchors.centerIn: parent;
                     visible: true;
                     antialiasing: true;
+
+                    Text {
+                        anchors.top: parent.bottom;
+                        anchors.horizontalCenter: parent.horizontalCenter;
+                        color: "white";
+                        style: Text.Outline;
+                        font.pixelSize: 20;
+                        visible: poster.visible && text !== "";
+                        text: {
+                            var msec = video.videoDuration;
+                            if (msec < 0) {
+                                return "";
+                            }
+                            var seconds = Math.floor(msec / 1000) % 60;
+                            return Math.floor(msec / 60000) + ":" +
+                                    (seconds < 10 ? "0" : "") + seconds;
+                        }
+                    }
                 }
 
 
@@ -119,19 +157,30 @@ Rectangle {
 
                 source: { currentPath.currentDir + slideMedia;}
 
-                fillMode: {
+                // the file was replaced on disk; open it again
+                property int revision: mediaRevision;
+                onRevisionChanged: {
+                    stop();
+                    source = "";
+                    source = Qt.binding(function() {
+                        return currentPath.currentDir + slideMedia;
+                    });
+                }
 
-                    if (backgroundScale === "fill") {
-                        VideoOutput.PreserveAspectCrop;
-                    }
-                    else if (backgroundScale === "stretch") {
-                        VideoOutput.Stretch;
-                    }
-                    else
-                    {
-                        VideoOutput.PreserveAspectFit;
+                // neighbouring slides are kept by the ListView, so the
+                // next video is opened and prerolled before it is shown
+                onStatusChanged: {
+                    if (status === MediaPlayer.Loaded &&
+                            playbackState === MediaPlayer.StoppedState) {
+                        video.pause();
                     }
+                }
 
+                // VideoOutput has no Pad mode; unscaled video is fitted
+                fillMode: {
+                    (backgroundScale === Slide.Unscaled) ?
+                                VideoOutput.PreserveAspectFit :
+                                backgroundScale;
                 }
 
                 function playToggle() {
@@ -146,6 +195,13 @@ Rectangle {
                     }
                 }
 
+                function stopPlayback() {
+                    if (video.playbackState === MediaPlayer.PlayingState) {
+                        playControl.z = video.z+1;
+                        video.pause();
+                    }
+                }
+
                 function forwardSeek() {
                     video.seek(video.position + 2000);  // 2000 msec
                 }
@@ -183,24 +239,13 @@ Rectangle {
         AnimatedImage {
             width : slideElement.width;
             height : slideElement.height;
-            source: { currentPath.currentDir + slideMedia; }
-            fillMode: {
-                // fill|fit|stretch|unscaled
-                if (backgroundScale === "fit") {
-                    Image.PreserveAspectFit;
-                }
-                else if (backgroundScale === "fill") {
-                    Image.PreserveAspectCrop;
-                }
-                else if (backgroundScale === "stretch") {
-                    Image.Stretch;
-                }
-                else if (backgroundScale === "unscaled")
-                {
-                    Image.Pad;
-                }
-
+            // a new query makes a replaced file load again
+            source: {
+                currentPath.currentDir + slideMedia +
+                        (mediaRevision > 0 ? "?" + mediaRevision : "");
             }
+            // Slide scale modes share their values with Image.fillMode
+            fillMode: backgroundScale;
         }
     }
 
@@ -234,6 +279,28 @@ Rectangle {
                 opacity: 0.3;
             }
 
+            // what the command writes, shown as it arrives; the model
+            // keeps only the latest lines
+            ListView {
+                width: slideElement.width * 0.9;
+                height: slideElement.height * 0.6;
+                anchors.bottom: parent.top;
+                anchors.horizontalCenter: parent.horizontalCenter;
+                model: slideCommands.output(index);
+                clip: true;
+                interactive: false;
+                visible: count > 0;
+                delegate: Text {
+                    text: line;
+                    textFormat: Text.PlainText;
+                    color: standardError ? "#ff8080" : "white";
+                    style: Text.Outline;
+                    font.pixelSize: scaleFont / 2;
+                    font.family: "Monospace";
+                }
+                onCountChanged: positionViewAtEnd();
+            }
+
         }
 
 
@@ -241,13 +308,18 @@ Rectangle {
 
     Loader {
         id: loadedComponent
+        // media is only loaded while the slide is within the media budget
+        active: slideResidency.residentRows.indexOf(index) !== -1;
+        // built between frames unless the slide is already on screen
+        asynchronous: !slideElement.ListView.isCurrentItem;
         sourceComponent: {
+            // by suffix, as mediaKind() decides in C++
             if (slideMedia.match(
-              /.avi|.flv|.mkv|.mov|.mp4|.mpeg|.ogv|.webm/i)) {
+              /\.(avi|flv|mkv|mov|mp4|mpeg|ogv|webm)$/i)) {
                 slideElement.isMediaSlide = true;
                 return videoComponent;
             }
-            else if (slideMedia.match(/.gif/i)) {
+            else if (slideMedia.match(/\.gif$/i)) {
                 return animatedComponent;
             }
 //            else if (command !== "") {
@@ -265,6 +337,7 @@ Rectangle {
 
     Loader {
         id: commandLoader
+        asynchronous: !slideElement.ListView.isCurrentItem;
         sourceComponent: {
             if (command !== "") {
                 slideElement.isCommandSlide = true;
@@ -273,150 +346,48 @@ Rectangle {
         }
     }
 
+    // the loaders may still be building their items
     onMediaSignal: {
         if (slideElement.isCommandSlide === true) {
-            commandLoader.item.playToggle();
+            if (commandLoader.item) {
+                commandLoader.item.playToggle();
+            }
         }
-        else {
+        else if (loadedComponent.item) {
             loadedComponent.item.playToggle();
         }
 
 
     }
 
-    onBackMedia: {
-        loadedComponent.item.backwardSeek();
-    }
-
-    onForwardMedia: {
-        loadedComponent.item.forwardSeek();
-    }
-
-
-
-    Rectangle {
-        id: slideTextBackground;
-        color: shadingColor;
-        opacity: {
-            if (slideTextData.text === "") {
-                return 0;
-            }
-            else {
-                return shadingOpacity;
-            }
-        }
-
-        height: {slideTextData.contentHeight + padding;}
-        width: {slideTextData.contentWidth + padding;}
-
-        anchors.margins: {0.02 * parent.width}
-
-        anchors.left: {
-            if (position === "left" || position === "top-left" ||
-                    position === "bottom-left") {
-                return parent.left;
-            }
-            else {
-                return undefined;
-            }
-        }
-
-        anchors.right: {
-            if (position === "right" || position === "top-right" ||
-                    position === "bottom-right") {
-                return parent.right;
-            }
-            else {
-                return undefined;
-            }
-        }
-        anchors.top: {
-            if (position === "top-left" || position === "top" ||
-                    position === "top-right") {
-                return parent.top;
-            }
-            else {
-                return undefined;
-            }
-        }
-        anchors.bottom: {
-            if (position === "bottom-left" ||
-                    position === "bottom" ||
-                    position === "bottom-right") {
-                return parent.bottom;
-            }
-            else {
-                return undefined;
-            }
-        }
-        anchors.centerIn: {
-            if (position === "center") {
-                return parent.Center;
-            }
-            else {
-                return undefined;
-            }
-        }
-        anchors.horizontalCenter: {
-            if (position === "top" || position === "center" ||
-                    position === "bottom") {
-                return parent.horizontalCenter;
-            }
-            else {
-                return;
-            }
-        }
-        anchors.verticalCenter: {
-            if (position === "left" || position === "center" ||
-                    position === "right") {
-                return parent.verticalCenter;
-            }
-            else {
-                return;
-            }
+    // slides next to the current one stay loaded, so leaving a playing
+    // video has to pause it
+    ListView.onIsCurrentItemChanged: {
+        if (!ListView.isCurrentItem && isMediaSlide &&
+                loadedComponent.item) {
+            loadedComponent.item.stopPlayback();
         }
     }
 
-
-
-
-
-
-    Text {
-        id: slideTextData;
-        //parent: slideTextBackground;
-        anchors.centerIn: slideTextBackground;
-        text: slideText;
-        color: textColor;
-        font.family: fontFamily;
-        font.pixelSize: {
-            scaleFont;
-        }
-        font.pointSize: 1;
-        width: slideTextBackground.width;
-        horizontalAlignment: {
-            if (pointyTextAlign == "left") {
-                return Text.AlignLeft;
-            }
-            else if (pointyTextAlign == "right") {
-                return Text.AlignRight;
-            }
-            else if (pointyTextAlign == "justify") {
-                return Text.AlignJustify;
-            }
-            else {
-                Text.AlignHCenter;
-            }
+    onBackMedia: {
+        if (loadedComponent.item) {
+            loadedComponent.item.backwardSeek();
         }
+    }
 
-        textFormat: {
-            (useMarkup === true)? Text.AutoText : Text.PlainText;
-
+    onForwardMedia: {
+        if (loadedComponent.item) {
+            loadedComponent.item.forwardSeek();
         }
-
     }
 
 
 
+    // the text and its shading, laid out and drawn in C++
+    PointySlideItem {
+        anchors.fill: parent;
+        slides: slideShow;
+        row: index;
+    }
 }
 
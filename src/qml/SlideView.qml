@@ -21,20 +21,28 @@
 
 
 import QtQuick 2.0
+import Pointy 1.0
 import QtQuick.Window 2.0
 
 
 Rectangle {
     id: mainView;
     width: 1024; height: 576;
+    // the notes and grid windows only exist while they are shown
     property bool notesVisible: false;
-    property bool gridVisible: true;
+    property bool gridVisible: false;
+    property QtObject notesWindow: null;
+    property QtObject gridWindow: null;
     property bool horizontalLayout: true;
 
+    // slide text is fitted to the window by the model
+    onWidthChanged: slideShow.setSlideSize(width, height);
+    onHeightChanged: slideShow.setSlideSize(width, height);
+    Component.onCompleted: slideShow.setSlideSize(width, height);
+
     signal toggleScreenMode();
     signal quitPointy();
     signal checkFileInfo();
-    signal sendCommand(string command);
 
     Rectangle {
         id: fadeRectangle;
@@ -66,6 +74,12 @@ Rectangle {
 
         model: slideShow;
 
+        // keep the slides either side of the current one instantiated, so
+        // their media is loaded before they are shown
+        cacheBuffer: {
+            (mainView.horizontalLayout) ? mainView.width : mainView.height;
+        }
+
         delegate:
             PointySlide {
             slideWidth: mainView.width;
@@ -78,6 +92,21 @@ Rectangle {
 
         property int slideCount: count;
 
+        // decide which slides may hold media, then decode the images of
+        // the neighbouring ones ahead of time
+        onCurrentIndexChanged: {
+            slideResidency.setCurrentSlide(currentIndex, mainView.width,
+                                           mainView.height);
+            slideImages.prefetchAround(currentIndex, mainView.width,
+                                       mainView.height);
+        }
+        onCountChanged: {
+            slideResidency.setCurrentSlide(currentIndex, mainView.width,
+                                           mainView.height);
+            slideImages.prefetchAround(currentIndex, mainView.width,
+                                       mainView.height);
+        }
+
         currentIndex: 0;
 
         Timer {
@@ -96,7 +125,7 @@ Rectangle {
         }
 
         function loadTransition(pointyTransition) {
-            if (dataView.opacity != 0.0 && pointyTransition === "fade") {
+            if (dataView.opacity != 0.0 && pointyTransition === Slide.Fade) {
                 animateFade.start();
             }
             else {
@@ -179,15 +208,6 @@ Rectangle {
             }
         }
 
-        function toggleWindow(windowId) {
-            if (windowId.visible === true) {
-                windowId.visible = false;
-            }
-            else {
-                windowId.show();
-            }
-
-        }
 
 
 
@@ -212,9 +232,9 @@ Rectangle {
 
             else if (event.key === Qt.Key_Return &&
                                 dataView.currentItem.isCommandSlide === true ) {
-                console.log("sending ", currentItem.commandOut);
                 dataView.currentItem.mediaSignal();
-                mainView.sendCommand(currentItem.commandOut);
+                slideCommands.runCommand(currentIndex,
+                                         currentItem.commandOut);
             }
 
 
@@ -243,125 +263,197 @@ Rectangle {
                 toggleScreenBlank();
             }
             else if (event.key === Qt.Key_N) {
-                toggleWindow(notesTextWindow);
+                mainView.notesVisible = !mainView.notesVisible;
             }
             else if (event.key === Qt.Key_G) {
-                toggleWindow(gridViewWindow);
+                mainView.gridVisible = !mainView.gridVisible;
+            }
+            else if (event.key === Qt.Key_M) {
+                console.log(slideResidency.report());
             }
         }
 
     } // ListView
 
-    Window {
-        id: notesTextWindow;
-        width: 400; height: 300;
+    // builds a window when it is shown, and destroys it, with its scene
+    // graph and delegates, when it is hidden
+    function updateWindow(window, component, visible) {
+        if (visible && window === null) {
+            window = component.createObject(mainView);
+            window.show();
+        }
+        else if (!visible && window !== null) {
+            window.destroy();
+            window = null;
+        }
+        return window;
+    }
+
+    onNotesVisibleChanged: {
+        notesWindow = updateWindow(notesWindow, notesWindowComponent,
+                                   notesVisible);
+    }
+    onGridVisibleChanged: {
+        gridWindow = updateWindow(gridWindow, gridWindowComponent,
+                                  gridVisible);
+    }
 
-        title: "Pointy Notes"
-        visible: mainView.notesVisible;
+    Component {
+        id: notesWindowComponent;
+        Window {
+            id: notesTextWindow;
+            width: 400; height: 300;
+
+            title: "Pointy Notes"
+            // closed by the window manager
+            onVisibleChanged: {
+                if (!visible) {
+                    mainView.notesVisible = false;
+                }
+            }
 
-        Text {
-            focus: true;
-            anchors.fill: parent
-            anchors.margins: parent.height * 0.1;
+            Text {
+                focus: true;
+                anchors.fill: parent
+                anchors.margins: parent.height * 0.1;
 
-            font.pixelSize: 50
-            wrapMode: Text.WordWrap
+                font.pixelSize: 50
+                wrapMode: Text.WordWrap
 
-            property string notes: dataView.currentItem.pointyNotes;
-            text: notes == "" ? "This slide has no notes." : notes;
-            font.italic: notes == "";
+                property string notes: dataView.currentItem.pointyNotes;
+                text: notes == "" ? "This slide has no notes." : notes;
+                font.italic: notes == "";
 
-            Keys.onPressed: {
-                if (event.key === Qt.Key_N) {
-                    if (notesTextWindow.visible === true )
-                    {
-                        notesTextWindow.visible = false;
+                Keys.onPressed: {
+                    if (event.key === Qt.Key_N) {
+                        mainView.notesVisible = false;
                     }
                 }
             }
-        }
-    } // Window (notesTextWindow)
-
-    Window {
-        id: gridViewWindow;
-        width: 400; height: 300;
-
-        title: "Pointy Grid View"
-        visible: mainView.gridVisible;
-
-        GridView {
-            id: gridView;
-            model: slideShow;
-            focus: true;
-            width: parent.width; height: parent.height;
-            currentIndex: dataView.currentIndex;
-            snapMode: GridView.SnapToRow;
-
-            cellWidth: {width/2;}
-            cellHeight: {height/2;}
-
-            delegate: PointySlide {
-                width: {gridView.cellWidth - 5}
-                height: {gridView.cellHeight - 5}
-                slideWidth: width;
-                slideHeight: height;
-                scaleFactor: {
-                    width/mainView.width;
+        } // Window (notesTextWindow)
+    }
+
+    Component {
+        id: gridWindowComponent;
+        Window {
+            id: gridViewWindow;
+            width: 400; height: 300;
+
+            title: "Pointy Grid View"
+            onVisibleChanged: {
+                if (!visible) {
+                    mainView.gridVisible = false;
                 }
-                MouseArea {
-                    id: mouseGridArea;
-                    anchors.fill: parent;
-                    acceptedButtons: Qt.LeftButton | Qt.RightButton
-                    onClicked: {
-                        if (mouse.button === Qt.LeftButton) {
-                            // index role is available to delegate
-                            dataView.currentIndex = index;
+            }
+
+            GridView {
+                id: gridView;
+                model: slideShow;
+                focus: true;
+                width: parent.width; height: parent.height;
+                currentIndex: dataView.currentIndex;
+                snapMode: GridView.SnapToRow;
+
+                cellWidth: {width/2;}
+                cellHeight: {height/2;}
+                // the rows above and below are built between frames
+                cacheBuffer: cellHeight;
+
+                // prerendered thumbnails rather than full slides, so the grid
+                // does not load its own copy of every slide's media
+                delegate: Item {
+                    width: {gridView.cellWidth - 5}
+                    height: {gridView.cellHeight - 5}
+
+                    // opening the window builds its cells a few at a time
+                    Loader {
+                        anchors.fill: parent;
+                        asynchronous: true;
+                        sourceComponent: thumbnailCell;
+                    }
+
+                    Component {
+                        id: thumbnailCell;
+                        Image {
+                            id: thumbnail;
+                            asynchronous: true;
+                            cache: false;
+                            // sized by the Loader once it is built; a
+                            // replaced media file has a new thumbnail
+                            source: {
+                                (width > 0 && height > 0 &&
+                                 mediaRevision >= 0) ?
+                                            slideThumbnails.thumbnailUrl(
+                                                index, width, height,
+                                                mainView.width) : "";
+                            }
+
+                            Connections {
+                                target: slideThumbnails;
+                                onThumbnailReady: {
+                                    if (String(url) ===
+                                            String(thumbnail.source)) {
+                                        var rendered = thumbnail.source;
+                                        thumbnail.source = "";
+                                        thumbnail.source = rendered;
+                                    }
+                                }
+                            }
                         }
-                        else {
-                            console.log("Right")
+                    }
+
+                    MouseArea {
+                        id: mouseGridArea;
+                        anchors.fill: parent;
+                        acceptedButtons: Qt.LeftButton | Qt.RightButton
+                        onClicked: {
+                            if (mouse.button === Qt.LeftButton) {
+                                // index role is available to delegate
+                                dataView.currentIndex = index;
+                            }
+                            else {
+                                console.log("Right")
+                            }
                         }
                     }
                 }
-            }
 
-            highlight: Rectangle {
-                border.color: "#ffae00"
-                color: "transparent";
-                opacity: 1.0;
-                border.width: 1;
-                radius: 2;
-
-                width: gridView.cellWidth;
-                height: gridView.cellHeight;
-                x: gridView.currentItem.x;
-                y: gridView.currentItem.y;
-                z: {gridView.currentItem.z + 1;}    // put highlight on top
-                Rectangle {
-                    width: parent.width;
-                    height: parent.height;
-                    opacity: 0.2;
-                    color: "gold";
-                    radius: parent.radius;
-                }
+                highlight: Rectangle {
+                    border.color: "#ffae00"
+                    color: "transparent";
+                    opacity: 1.0;
+                    border.width: 1;
+                    radius: 2;
+
+                    width: gridView.cellWidth;
+                    height: gridView.cellHeight;
+                    x: gridView.currentItem.x;
+                    y: gridView.currentItem.y;
+                    z: {gridView.currentItem.z + 1;}    // put highlight on top
+                    Rectangle {
+                        width: parent.width;
+                        height: parent.height;
+                        opacity: 0.2;
+                        color: "gold";
+                        radius: parent.radius;
+                    }
 
-            }
+                }
 
 
-            Keys.onPressed: {
-                if (event.key === Qt.Key_G) {
-                    if (gridViewWindow.visible === true )
-                    {
-                        gridViewWindow.visible = false;
+                Keys.onPressed: {
+                    if (event.key === Qt.Key_G) {
+                        mainView.gridVisible = false;
+                    }
+                    if (event.key === Qt.Key_Return) {
+                        dataView.currentIndex = currentIndex;
                     }
                 }
-                if (event.key === Qt.Key_Return) {
-                    dataView.currentIndex = currentIndex;
-                }
-            }
-            highlightFollowsCurrentItem: true;
-            highlightMoveDuration: 0;
+                highlightFollowsCurrentItem: true;
+                highlightMoveDuration: 0;
 
-        }
+            }
+        } // Window (gridViewWindow)
     }
 
 
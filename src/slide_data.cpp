@@ -20,183 +20,439 @@
  */
 
 #include "slide_data.h"
-#include <qregexp.h>
 #include <qcolor.h>
 #include <qfont.h>
 #include <qfontinfo.h>
 #include <QMessageLogger>
 #include <qdebug.h>
+#include <cstring>
 
 namespace pointy {
 
-SlideData::SlideData():
-    stageColor("black"), font("Sans"), fontSize(60), fontSizeUnit("px"),
+SlideStyle::SlideStyle():
+    stageColor(Qt::black), font("Sans"), fontSize(60), fontSizeUnit("px"),
     notesFont("Sans"),
-    notesFontSize("20px"), textColor("white"), textAlign("center"),
-    shadingColor("black"), shadingOpacity(0.66), duration(30),
-    command(), transition("fade"), cameraFrameRate(0), backgroundScale("fill"),
-    position("center"), useMarkup(true), slideText(""), maxLineLength(0),
-    slideMedia(),
-    backgroundColor("white"), notesText(), slideNumber(0)
+    notesFontSize("20px"), textColor(Qt::white),
+    textAlign(SlideEnums::AlignCenter),
+    shadingColor(Qt::black), shadingOpacity(0.66), duration(30),
+    transition(SlideEnums::Fade), cameraFrameRate(0),
+    backgroundScale(SlideEnums::Fill),
+    position(SlideEnums::Center), useMarkup(true), backgroundColor(Qt::white),
+    mediaBudget(0)
 {}
 
-void SlideData::slideSettingAssign(const QString &lhs_in,
-                                   const QString &rhs_in)
+bool SlideStyle::operator==(const SlideStyle& other) const
 {
-    QString lhs((lhs_in.toLower()).trimmed());
-    QString rhs(rhs_in.trimmed());
+    return stageColor == other.stageColor && font == other.font &&
+            fontSize == other.fontSize &&
+            fontSizeUnit == other.fontSizeUnit &&
+            notesFont == other.notesFont &&
+            notesFontSize == other.notesFontSize &&
+            textColor == other.textColor && textAlign == other.textAlign &&
+            shadingColor == other.shadingColor &&
+            shadingOpacity == other.shadingOpacity &&
+            duration == other.duration && transition == other.transition &&
+            cameraFrameRate == other.cameraFrameRate &&
+            backgroundScale == other.backgroundScale &&
+            position == other.position && useMarkup == other.useMarkup &&
+            backgroundColor == other.backgroundColor &&
+            mediaBudget == other.mediaBudget;
+}
 
-    if (lhs == "stage-color") {
-        if (QColor::isValidColor(rhs)) {
-            this->stageColor = rhs;
+uint qHash(const SlideStyle& style, uint seed)
+{
+    // only needs to separate the styles of one deck, so the cheap fields
+    // are left out
+    uint hash = seed;
+    hash ^= qHash(style.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= style.textColor.rgba() + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= style.backgroundColor.rgba() + 0x9e3779b9 +
+            (hash << 6) + (hash >> 2);
+    hash ^= uint(style.position) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= uint(style.fontSize) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+QDataStream& operator<<(QDataStream& stream, const SlideStyle& style)
+{
+    stream << style.stageColor << style.font << style.fontSize <<
+              style.fontSizeUnit << style.notesFont << style.notesFontSize <<
+              style.textColor << qint32(style.textAlign) <<
+              style.shadingColor << style.shadingOpacity << style.duration <<
+              qint32(style.transition) << qint32(style.cameraFrameRate) <<
+              qint32(style.backgroundScale) << qint32(style.position) <<
+              style.useMarkup << style.backgroundColor <<
+              qint32(style.mediaBudget);
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, SlideStyle& style)
+{
+    qint32 textAlign, transition, cameraFrameRate, backgroundScale, position,
+            mediaBudget;
+    stream >> style.stageColor >> style.font >> style.fontSize >>
+              style.fontSizeUnit >> style.notesFont >> style.notesFontSize >>
+              style.textColor >> textAlign >>
+              style.shadingColor >> style.shadingOpacity >> style.duration >>
+              transition >> cameraFrameRate >>
+              backgroundScale >> position >>
+              style.useMarkup >> style.backgroundColor >> mediaBudget;
+    style.textAlign = SlideEnums::TextAlign(textAlign);
+    style.transition = SlideEnums::Transition(transition);
+    style.cameraFrameRate = cameraFrameRate;
+    style.backgroundScale = SlideEnums::ScaleMode(backgroundScale);
+    style.position = SlideEnums::Position(position);
+    style.mediaBudget = mediaBudget;
+    return stream;
+}
+
+SlideData::SlideData():
+    command(), slideText(""), maxLineLength(0), slideMedia(), notesText(),
+    slideNumber(0), blockHash(0), styleData(new SlideStyle)
+{}
+
+void SlideStylePool::intern(SlideData& slide)
+{
+    const SlideStyle& style = slide.style();
+    const uint hash = qHash(style);
+    QMultiHash<uint, QSharedDataPointer<SlideStyle> >::const_iterator iter =
+            styles.constFind(hash);
+    while (iter != styles.constEnd() && iter.key() == hash) {
+        if (iter.value().constData() == &style) {
+            return;
         }
+        if (*iter.value().constData() == style) {
+            slide.styleData = iter.value();
+            return;
+        }
+        ++iter;
     }
-    else if (lhs == "font") {
-        setFont(rhs);
-    }
-    else if (lhs == "notes-font") {
-        this->notesFont = rhs;
-    }
-    else if (lhs == "notes-font-size") {
-        this->notesFontSize = rhs;
+    styles.insert(hash, slide.styleData);
+}
+
+int SlideStylePool::size() const
+{
+    return styles.size();
+}
+
+namespace {
+
+enum SettingKey {
+    StageColorKey,
+    FontKey,
+    NotesFontKey,
+    NotesFontSizeKey,
+    TextColorKey,
+    TextAlignKey,
+    ShadingColorKey,
+    ShadingOpacityKey,
+    DurationKey,
+    CommandKey,
+    TransitionKey,
+    CameraFrameRateKey,
+    MediaBudgetKey,
+    UnknownKey
+};
+
+struct SettingKeyword {
+    const char* name;
+    int value;
+};
+
+// All tables must stay sorted by name, they are binary searched
+const SettingKeyword settingKeys[] = {
+    { "camera-framerate", CameraFrameRateKey },
+    { "command", CommandKey },
+    { "duration", DurationKey },
+    { "font", FontKey },
+    { "media-budget", MediaBudgetKey },
+    { "notes-font", NotesFontKey },
+    { "notes-font-size", NotesFontSizeKey },
+    { "shading-color", ShadingColorKey },
+    { "shading-opacity", ShadingOpacityKey },
+    { "stage-color", StageColorKey },
+    { "text-align", TextAlignKey },
+    { "text-color", TextColorKey },
+    { "transition", TransitionKey }
+};
+
+const SettingKeyword positionKeys[] = {
+    { "bottom", SlideEnums::Bottom },
+    { "bottom-left", SlideEnums::BottomLeft },
+    { "bottom-right", SlideEnums::BottomRight },
+    { "center", SlideEnums::Center },
+    { "left", SlideEnums::Left },
+    { "right", SlideEnums::Right },
+    { "top", SlideEnums::Top },
+    { "top-left", SlideEnums::TopLeft },
+    { "top-right", SlideEnums::TopRight }
+};
+
+const SettingKeyword scaleKeys[] = {
+    { "fill", SlideEnums::Fill },
+    { "fit", SlideEnums::Fit },
+    { "stretch", SlideEnums::Stretch },
+    { "unscaled", SlideEnums::Unscaled }
+};
+
+const SettingKeyword textAlignKeys[] = {
+    { "center", SlideEnums::AlignCenter },
+    { "justify", SlideEnums::AlignJustify },
+    { "left", SlideEnums::AlignLeft },
+    { "right", SlideEnums::AlignRight }
+};
+
+const SettingKeyword transitionKeys[] = {
+    { "fade", SlideEnums::Fade },
+    { "none", SlideEnums::NoTransition },
+    { "slide", SlideEnums::SlideTransition }
+};
+
+const int maxKeywordLength = 32;
+
+template <int N>
+int findKeyword(const SettingKeyword (&table)[N], const QString& word,
+                int notFound)
+{
+    // keywords are ASCII, so fold into a stack buffer rather than a QString
+    const int length = word.size();
+    if (length == 0 || length >= maxKeywordLength) {
+        return notFound;
     }
-    else if (lhs == "text-color") {
-        if (QColor::isValidColor(rhs)) {
-            this->textColor = rhs;
+    char key[maxKeywordLength];
+    const QChar* chars = word.constData();
+    for (int i = 0; i < length; ++i) {
+        ushort c = chars[i].unicode();
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
         }
-
+        else if (c > 0x7f || c == 0) {
+            return notFound;
+        }
+        key[i] = char(c);
     }
-    else if (lhs == "text-align") {
-        if (rhs == "left" || rhs == "right" || rhs == "center" ||
-                rhs == "justify" ) {
-            this->textAlign = rhs;
+    key[length] = '\0';
+
+    int low = 0;
+    int high = N - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        int order = strcmp(key, table[middle].name);
+        if (order == 0) {
+            return table[middle].value;
+        }
+        if (order < 0) {
+            high = middle - 1;
         }
         else {
-            this->textAlign = "center";
+            low = middle + 1;
         }
     }
-    else if (lhs == "shading-color") {
-        if (QColor::isValidColor(rhs)) {
-            this->shadingColor = rhs;
+    return notFound;
+}
+
+template <int N>
+QString keywordName(const SettingKeyword (&table)[N], int value)
+{
+    for (int i = 0; i < N; ++i) {
+        if (table[i].value == value) {
+            return QLatin1String(table[i].name);
         }
     }
-    else if (lhs == "shading-opacity") {
+    return QString();
+}
+
+bool isWordChar(QChar c)
+{
+    return c.isLetterOrNumber() || c.isMark() || c == QLatin1Char('_');
+}
+
+}   // namespace
+
+QString positionName(SlideEnums::Position position)
+{
+    return keywordName(positionKeys, position);
+}
+
+QString textAlignName(SlideEnums::TextAlign textAlign)
+{
+    return keywordName(textAlignKeys, textAlign);
+}
+
+QString scaleModeName(SlideEnums::ScaleMode scaleMode)
+{
+    return keywordName(scaleKeys, scaleMode);
+}
+
+QString transitionName(SlideEnums::Transition transition)
+{
+    return keywordName(transitionKeys, transition);
+}
+
+void SlideData::slideSettingAssign(const QString &lhs_in,
+                                   const QString &rhs_in)
+{
+    QString rhs(rhs_in.trimmed());
+
+    switch (findKeyword(settingKeys, lhs_in.trimmed(), UnknownKey)) {
+    case StageColorKey:
+        if (QColor::isValidColor(rhs)) {
+            styleData->stageColor.setNamedColor(rhs);
+        }
+        break;
+    case FontKey:
+        setFont(rhs);
+        break;
+    case NotesFontKey:
+        styleData->notesFont = rhs;
+        break;
+    case NotesFontSizeKey:
+        styleData->notesFontSize = rhs;
+        break;
+    case TextColorKey:
+        if (QColor::isValidColor(rhs)) {
+            styleData->textColor.setNamedColor(rhs);
+        }
+        break;
+    case TextAlignKey:
+        styleData->textAlign = SlideEnums::TextAlign(
+                    findKeyword(textAlignKeys, rhs, SlideEnums::AlignCenter));
+        break;
+    case ShadingColorKey:
+        if (QColor::isValidColor(rhs)) {
+            styleData->shadingColor.setNamedColor(rhs);
+        }
+        break;
+    case ShadingOpacityKey: {
         bool ok;
         qreal temp = rhs.toFloat(&ok);
-        if (!ok) {
-            return;
-        }
-        else {
-            if (temp >= 0.0 && temp <= 1.0) {
-                this->shadingOpacity = temp;
-            }
-
+        if (ok && temp >= 0.0 && temp <= 1.0) {
+            styleData->shadingOpacity = temp;
         }
+        break;
     }
-    else if (lhs == "duration") {
+    case DurationKey: {
         bool ok;
         qreal temp = rhs.toFloat(&ok);
-        if (!ok) {
-            return;
-        }
-        else {
-            this->duration = temp;
+        if (ok) {
+            styleData->duration = temp;
         }
+        break;
     }
-    else if (lhs == "command") {
+    case CommandKey:
         this->command = rhs;
-    }
-    else if (lhs == "transition") {
-        this->transition = rhs;
-    }
-    else if (lhs == "camera-framerate") {
+        break;
+    case TransitionKey:
+        styleData->transition = SlideEnums::Transition(
+                    findKeyword(transitionKeys, rhs, SlideEnums::NoTransition));
+        break;
+    case CameraFrameRateKey: {
         bool ok;
         int temp = rhs.toInt(&ok);
-        if (!ok) {
-            return;
+        if (ok) {
+            styleData->cameraFrameRate = temp;
         }
-        else {
-            this->cameraFrameRate = temp;
+        break;
+    }
+    case MediaBudgetKey: {
+        bool ok;
+        int temp = rhs.toInt(&ok);
+        if (ok && temp >= 0) {
+            styleData->mediaBudget = temp;
         }
+        break;
+    }
+    default:
+        break;
     }
-
 }
 
 void SlideData::slideSettingAssign(const QString& setting)
 {
     QString input = setting.trimmed();
 
-    if (input.indexOf(".") != -1) {
+    if (input.indexOf(QLatin1Char('.')) != -1) {
         this->slideMedia = input;
+        return;
     }
-    else {
-        QString lowerInput = input.toLower();
-        if (lowerInput.indexOf("markup") != -1) {
-            if (lowerInput == "no-markup") {
-                this->useMarkup = false;
-            }
-            else {
-                this->useMarkup = true;
 
-            }
-        }
-        else if ((QRegExp("fill|fit|stretch|unscaled")
-                  .exactMatch(lowerInput))) {
-            this->backgroundScale = lowerInput;
-        }
-        else if (isValidPosition(lowerInput)) {
-            this->position = lowerInput;
-        }
-        else if (QColor::isValidColor(lowerInput)) {
-            this->backgroundColor = lowerInput;
-            this->slideMedia = QString();
-        }
+    if (input.indexOf(QLatin1String("markup"), 0, Qt::CaseInsensitive) != -1) {
+        styleData->useMarkup =
+                input.compare(QLatin1String("no-markup"),
+                              Qt::CaseInsensitive) != 0;
+        return;
     }
 
+    int keyword = findKeyword(scaleKeys, input, -1);
+    if (keyword != -1) {
+        styleData->backgroundScale = SlideEnums::ScaleMode(keyword);
+        return;
+    }
+    keyword = findKeyword(positionKeys, input, -1);
+    if (keyword != -1) {
+        styleData->position = SlideEnums::Position(keyword);
+        return;
+    }
+    QString lowerInput = input.toLower();
+    if (QColor::isValidColor(lowerInput)) {
+        styleData->backgroundColor.setNamedColor(lowerInput);
+        this->slideMedia = QString();
+    }
 }
 
 bool SlideData::isValidPosition(const QString& testString)
 {
-    return(QRegExp("(top-left|top|top-right|"
-                   "left|center|right|"
-                   "bottom-left|bottom|bottom-right)")
-            .exactMatch(testString));
+    return findKeyword(positionKeys, testString, -1) != -1;
 }
 
 void SlideData::setFont(const QString &fontString)
 {
+    // matches "\w+ \d+ ?p(x|t)", e.g. "Sans 50px" or "Sans 50 px"
     QString testFont = fontString.toLower().trimmed();
-    if ((QRegExp("(\\w+ \\d+ ?p(x|t))")).exactMatch(testFont))
-        // 1+ alphanumeric chars followed by a space "\\w+ "
-        // 1+ decimal digits followed by optional space "\\d ?"
-        // either px or pt "p(x|t)"
-    {
-        int splitIndex = testFont.indexOf(QRegExp(" \\d+ ?[Pp]([Xx]|[Tt])"));
-        QString possibleFont = (testFont.left(splitIndex)).trimmed();
-        this->font = possibleFont;
-
-        int splitUnitIndex = (testFont.mid(splitIndex)).
-                indexOf(QRegExp("p(x|t)"));
-        QStringList fontSettings;
-        fontSettings.append((testFont.mid(splitIndex,
-                                           splitUnitIndex)).trimmed());
-        fontSettings.append(((testFont.mid(splitIndex)).
-                             mid(splitUnitIndex)).trimmed());
-        bool ok;
-        qreal tempSize = fontSettings[0].toFloat(&ok);
-        if (ok) {
-            if (tempSize > 0) {
-                this->fontSize = tempSize;
-            }
+    const QChar* chars = testFont.constData();
+    const int length = testFont.size();
 
+    int splitIndex = 0;
+    while (splitIndex < length && isWordChar(chars[splitIndex])) {
+        ++splitIndex;
+    }
+    if (splitIndex == 0 || splitIndex == length ||
+            chars[splitIndex] != QLatin1Char(' ')) {
+        return;
+    }
+    int sizeStart = splitIndex + 1;
+    int sizeEnd = sizeStart;
+    while (sizeEnd < length && chars[sizeEnd].isDigit()) {
+        ++sizeEnd;
+    }
+    if (sizeEnd == sizeStart) {
+        return;
+    }
+    int unitStart = sizeEnd;
+    if (unitStart < length && chars[unitStart] == QLatin1Char(' ')) {
+        ++unitStart;
+    }
+    if (length - unitStart != 2 || chars[unitStart] != QLatin1Char('p') ||
+            (chars[unitStart + 1] != QLatin1Char('x') &&
+             chars[unitStart + 1] != QLatin1Char('t'))) {
+        return;
+    }
+
+    styleData->font = testFont.left(splitIndex);
+
+    bool ok;
+    qreal tempSize = testFont.mid(sizeStart, sizeEnd - sizeStart).toFloat(&ok);
+    if (ok) {
+        if (tempSize > 0) {
+            styleData->fontSize = tempSize;
         }
-          // pointsize not supported for now
-//        if (fontSettings[1].toLower() == "pt") {
-//            this->fontSizeUnit = "pt";
-//        }
-        else {
-            this->fontSizeUnit = "px";
-        }
+    }
+      // pointsize not supported for now
+//    if (testFont.mid(unitStart) == "pt") {
+//        styleData->fontSizeUnit = "pt";
+//    }
+    else {
+        styleData->fontSizeUnit = "px";
     }
 }
 
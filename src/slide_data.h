@@ -25,45 +25,92 @@
 
 #include <QtCore/qstring.h>
 #include <QtCore/qlist.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qshareddata.h>
 #include <qsharedpointer.h>
+#include <qcolor.h>
+#include <qdatastream.h>
+#include "slide_enums.h"
 
 namespace pointy {
 
-class SlideData
+// Settings that slides inherit from the header.  Slides share one
+// SlideStyle until they override a setting, and SlideStylePool then folds
+// slides with identical overrides back onto a single instance.
+class SlideStyle: public QSharedData
 {
 public:
-    SlideData();
+    SlideStyle();
+
+    bool operator==(const SlideStyle& other) const;
 
-    QString stageColor;		// transition tint
+    QColor stageColor;		// transition tint
     QString font;
     qreal fontSize;
     QString fontSizeUnit;
     QString notesFont;
     QString notesFontSize;
-    QString textColor;
-    QString textAlign;
-    QString shadingColor; 		// text rectangle bground color
+    QColor textColor;
+    SlideEnums::TextAlign textAlign;
+    QColor shadingColor; 		// text rectangle bground color
     qreal shadingOpacity;
     qreal duration;
-    QString command;
-    QString transition;
+    SlideEnums::Transition transition;
     int cameraFrameRate;
-    QString backgroundScale;
-    QString position;
+    SlideEnums::ScaleMode backgroundScale;
+    SlideEnums::Position position;
     bool useMarkup;
+    QColor backgroundColor;
+    int mediaBudget;            // MiB of decoded media, 0 for the default
+};
+
+uint qHash(const SlideStyle& style, uint seed = 0);
+
+QDataStream& operator<<(QDataStream& stream, const SlideStyle& style);
+QDataStream& operator>>(QDataStream& stream, SlideStyle& style);
+
+// setting keywords, as written in .pin files
+QString positionName(SlideEnums::Position position);
+QString textAlignName(SlideEnums::TextAlign textAlign);
+QString scaleModeName(SlideEnums::ScaleMode scaleMode);
+QString transitionName(SlideEnums::Transition transition);
+
+class SlideData
+{
+public:
+    SlideData();
+
+    const SlideStyle& style() const { return *styleData; }
+
+    QString command;
     QString slideText;
     int maxLineLength;
     QString slideMedia;
-    QString backgroundColor;
     QString notesText;
     int slideNumber;
+    uint blockHash;     // hash of the header and this slide's source text
 
     void slideSettingAssign(const QString& lhs_in, const QString& rhs_in);
     void slideSettingAssign(const QString& setting);
     void setFont(const QString& fontString);
 
 private:
+    friend class SlideStylePool;
+    friend class SlideDeckCache;
+
     bool isValidPosition(const QString& testString);
+
+    QSharedDataPointer<SlideStyle> styleData;
+};
+
+class SlideStylePool
+{
+public:
+    void intern(SlideData& slide);
+    int size() const;
+
+private:
+    QMultiHash<uint, QSharedDataPointer<SlideStyle> > styles;
 };
 
 }   // namespace pointy
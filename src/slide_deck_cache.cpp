@@ -0,0 +1,200 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_deck_cache.h"
+#include "slide_file_buffer.h"
+#include <qbytearray.h>
+#include <qcryptographichash.h>
+#include <qdatastream.h>
+#include <qdatetime.h>
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qhash.h>
+#include <qsavefile.h>
+#include <qvector.h>
+
+namespace pointy {
+
+namespace {
+
+const quint32 cacheMagic = 0x50494e43;      // "PINC"
+const quint32 cacheVersion = 3;             // bump on any layout change
+
+qint64 remainingBytes(const QDataStream& stream)
+{
+    return stream.device()->size() - stream.device()->pos();
+}
+
+}   // namespace
+
+SlideDeckCache::SlideDeckCache(const QString& cacheDir):
+    cacheDir(cacheDir)
+{}
+
+QString SlideDeckCache::cacheFileName(const QString& fileName) const
+{
+    QByteArray path = QFileInfo(fileName).absoluteFilePath().toUtf8();
+    QByteArray name = QCryptographicHash::hash(path, QCryptographicHash::Sha1);
+    return QDir(cacheDir).filePath(QString::fromLatin1(name.toHex()) +
+                                   QLatin1String(".pindeck"));
+}
+
+SlideDeckCache::Key SlideDeckCache::sourceKey(const QString& fileName,
+                                              const SlideFileBuffer& source)
+{
+    QFileInfo info(fileName);
+    Key key;
+    key.path = info.absoluteFilePath();
+    key.modified = info.lastModified().toMSecsSinceEpoch();
+    key.size = source.size();
+    key.contentHash = QCryptographicHash::hash(
+                QByteArray::fromRawData(source.data(), source.size()),
+                QCryptographicHash::Sha1);
+    return key;
+}
+
+// Layout, all through QDataStream:
+//   magic, version, path, modified, size, contentHash,
+//   style count, styles,
+//   slide count, then per slide its style index and own fields
+bool SlideDeckCache::load(const Key& source,
+                          QList<QSharedPointer<SlideData> >& slides) const
+{
+    SlideFileBuffer cacheFile;
+    if (!cacheFile.open(cacheFileName(source.path))) {
+        return false;
+    }
+    const QByteArray bytes = QByteArray::fromRawData(cacheFile.data(),
+                                                     cacheFile.size());
+    QDataStream stream(bytes);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != cacheMagic || version != cacheVersion) {
+        return false;
+    }
+    Key cached;
+    stream >> cached.path >> cached.modified >> cached.size >>
+              cached.contentHash;
+    if (stream.status() != QDataStream::Ok || cached.path != source.path ||
+            cached.modified != source.modified ||
+            cached.size != source.size ||
+            cached.contentHash != source.contentHash) {
+        return false;
+    }
+
+    qint32 styleCount;
+    stream >> styleCount;
+    if (styleCount < 0) {
+        return false;
+    }
+    // counts come from disk; every entry takes at least a byte, so a
+    // corrupt count can not reserve more than the file could hold
+    QVector<QSharedDataPointer<SlideStyle> > styles;
+    styles.reserve(qMin<qint64>(styleCount, remainingBytes(stream)));
+    for (qint32 i = 0; i < styleCount; ++i) {
+        QSharedDataPointer<SlideStyle> style(new SlideStyle);
+        stream >> *style;
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+        styles.append(style);
+    }
+
+    qint32 slideCount;
+    stream >> slideCount;
+    if (stream.status() != QDataStream::Ok || slideCount < 0) {
+        return false;
+    }
+    QList<QSharedPointer<SlideData> > cachedSlides;
+    cachedSlides.reserve(qMin<qint64>(slideCount, remainingBytes(stream)));
+    for (qint32 i = 0; i < slideCount; ++i) {
+        QSharedPointer<SlideData> slide(new SlideData);
+        qint32 styleIndex, maxLineLength, slideNumber;
+        quint32 blockHash;
+        stream >> styleIndex >> slide->command >> slide->slideText >>
+                  maxLineLength >> slide->slideMedia >> slide->notesText >>
+                  slideNumber >> blockHash;
+        if (stream.status() != QDataStream::Ok || styleIndex < 0 ||
+                styleIndex >= styles.size()) {
+            return false;
+        }
+        slide->styleData = styles.at(styleIndex);
+        slide->maxLineLength = maxLineLength;
+        slide->slideNumber = slideNumber;
+        slide->blockHash = blockHash;
+        cachedSlides.append(slide);
+    }
+
+    slides.append(cachedSlides);
+    return true;
+}
+
+bool SlideDeckCache::save(const Key& source,
+                          const QList<QSharedPointer<SlideData> >& slides) const
+{
+    if (!QDir().mkpath(cacheDir)) {
+        return false;
+    }
+
+    // slides already share their interned styles; store each one once
+    QHash<const SlideStyle*, qint32> styleIndex;
+    QList<const SlideStyle*> styles;
+    for (int i = 0; i < slides.size(); ++i) {
+        const SlideStyle* style = &slides.at(i)->style();
+        if (!styleIndex.contains(style)) {
+            styleIndex.insert(style, styles.size());
+            styles.append(style);
+        }
+    }
+
+    QSaveFile file(cacheFileName(source.path));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << cacheMagic << cacheVersion << source.path << source.modified <<
+              source.size << source.contentHash;
+
+    stream << qint32(styles.size());
+    for (int i = 0; i < styles.size(); ++i) {
+        stream << *styles.at(i);
+    }
+    stream << qint32(slides.size());
+    for (int i = 0; i < slides.size(); ++i) {
+        const SlideData& slide = *slides.at(i);
+        stream << styleIndex.value(&slide.style()) << slide.command <<
+                  slide.slideText << qint32(slide.maxLineLength) <<
+                  slide.slideMedia << slide.notesText <<
+                  qint32(slide.slideNumber) << quint32(slide.blockHash);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+}   // namespace pointy
@@ -0,0 +1,70 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_DECK_CACHE_H
+#define SLIDE_DECK_CACHE_H
+
+#include "slide_data.h"
+#include <qbytearray.h>
+#include <qlist.h>
+#include <qsharedpointer.h>
+#include <qstring.h>
+
+namespace pointy {
+
+class SlideFileBuffer;
+
+// Binary copy of a parsed slide file, kept in cacheDir so that unchanged
+// decks skip the parser.  A cache file is only trusted when the source
+// path, modification time, size and SHA-1 of the contents all match the
+// ones it was written for; anything else is treated as a miss.  The key is
+// taken once, by the thread reading the file, for both load() and save().
+class SlideDeckCache
+{
+public:
+    struct Key
+    {
+        QString path;
+        qint64 modified;
+        qint64 size;
+        QByteArray contentHash;     // SHA-1
+    };
+
+    explicit SlideDeckCache(const QString& cacheDir);
+
+    static Key sourceKey(const QString& fileName,
+                         const SlideFileBuffer& source);
+
+    bool load(const Key& source,
+              QList<QSharedPointer<SlideData> >& slides) const;
+    bool save(const Key& source,
+              const QList<QSharedPointer<SlideData> >& slides) const;
+
+    QString cacheFileName(const QString& fileName) const;
+
+private:
+    QString cacheDir;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_DECK_CACHE_H
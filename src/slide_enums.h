@@ -0,0 +1,83 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_ENUMS_H
+#define SLIDE_ENUMS_H
+
+#include <qobject.h>
+
+namespace pointy {
+
+// Typed slide settings, exposed to QML as "Slide" in "import Pointy 1.0".
+// Values are chosen so that QML can use them without translating them.
+class SlideEnums: public QObject
+{
+    Q_OBJECT
+    Q_ENUMS(Position TextAlign ScaleMode Transition)
+
+public:
+    // text box anchoring; test the edge bits for each anchor
+    enum Position {
+        LeftEdge = 0x01,
+        RightEdge = 0x02,
+        HorizontalCenter = 0x04,
+        TopEdge = 0x10,
+        BottomEdge = 0x20,
+        VerticalCenter = 0x40,
+
+        TopLeft = TopEdge | LeftEdge,
+        Top = TopEdge | HorizontalCenter,
+        TopRight = TopEdge | RightEdge,
+        Left = VerticalCenter | LeftEdge,
+        Center = VerticalCenter | HorizontalCenter,
+        Right = VerticalCenter | RightEdge,
+        BottomLeft = BottomEdge | LeftEdge,
+        Bottom = BottomEdge | HorizontalCenter,
+        BottomRight = BottomEdge | RightEdge
+    };
+
+    // same values as Text.horizontalAlignment
+    enum TextAlign {
+        AlignLeft = Qt::AlignLeft,
+        AlignRight = Qt::AlignRight,
+        AlignCenter = Qt::AlignHCenter,
+        AlignJustify = Qt::AlignJustify
+    };
+
+    // same values as Image.fillMode
+    enum ScaleMode {
+        Stretch = 0,
+        Fit = 1,        // Image.PreserveAspectFit
+        Fill = 2,       // Image.PreserveAspectCrop
+        Unscaled = 6    // Image.Pad
+    };
+
+    enum Transition {
+        Fade,
+        SlideTransition,
+        NoTransition
+    };
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_ENUMS_H
@@ -0,0 +1,93 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_file_buffer.h"
+#include <limits>
+
+namespace pointy {
+
+SlideFileBuffer::SlideFileBuffer():
+    mapping(0), mappedSize(0)
+{}
+
+SlideFileBuffer::~SlideFileBuffer()
+{
+    close();
+}
+
+bool SlideFileBuffer::open(const QString& fileName)
+{
+    close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 fileSize = file.size();
+    if (!file.isSequential() && fileSize > 0 &&
+            fileSize <= std::numeric_limits<int>::max()) {
+        mapping = file.map(0, fileSize);
+        if (mapping) {
+            mappedSize = fileSize;
+            return true;
+        }
+    }
+
+    // fall back to buffered reads
+    contents = file.readAll();
+    return true;
+}
+
+void SlideFileBuffer::close()
+{
+    if (mapping) {
+        file.unmap(mapping);
+        mapping = 0;
+        mappedSize = 0;
+    }
+    contents.clear();
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+const char* SlideFileBuffer::data() const
+{
+    if (mapping) {
+        return reinterpret_cast<const char*>(mapping);
+    }
+    return contents.constData();
+}
+
+int SlideFileBuffer::size() const
+{
+    if (mapping) {
+        return int(mappedSize);
+    }
+    return contents.size();
+}
+
+bool SlideFileBuffer::isMapped() const
+{
+    return mapping != 0;
+}
+
+}   // namespace pointy
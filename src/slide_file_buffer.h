@@ -0,0 +1,59 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_FILE_BUFFER_H
+#define SLIDE_FILE_BUFFER_H
+
+#include <qbytearray.h>
+#include <qfile.h>
+#include <qstring.h>
+
+namespace pointy {
+
+// Gives read-only access to the whole contents of a slide file.  Regular
+// files are memory mapped; pipes, special files and anything else QFile
+// can not map are read into memory instead.
+class SlideFileBuffer
+{
+public:
+    SlideFileBuffer();
+    ~SlideFileBuffer();
+
+    bool open(const QString& fileName);
+    void close();
+
+    const char* data() const;
+    int size() const;
+    bool isMapped() const;
+
+private:
+    Q_DISABLE_COPY(SlideFileBuffer)
+
+    QFile file;
+    uchar* mapping;
+    qint64 mappedSize;
+    QByteArray contents;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_FILE_BUFFER_H
@@ -0,0 +1,251 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_file_watcher.h"
+#include <qcryptographichash.h>
+#include <qdatetime.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <QtConcurrent/qtconcurrentrun.h>
+
+namespace pointy {
+
+SlideFileWatcher::SlideFileWatcher(QObject* parent):
+    QObject(parent), compareContents(true)
+{
+    debounce.setSingleShot(true);
+    debounce.setInterval(debounceTime);
+    connect(&debounce, SIGNAL(timeout()), this, SLOT(checkPending()));
+    connect(&watcher, SIGNAL(fileChanged(QString)),
+            this, SLOT(fileNotice(QString)));
+    connect(&watcher, SIGNAL(directoryChanged(QString)),
+            this, SLOT(directoryNotice(QString)));
+}
+
+void SlideFileWatcher::setCompareContents(bool compare)
+{
+    compareContents = compare;
+}
+
+// the first hash is taken in the background, ready for the first check
+void SlideFileWatcher::addFile(const QString& fileName)
+{
+    QString path = QFileInfo(fileName).absoluteFilePath();
+    if (states.contains(path)) {
+        return;
+    }
+    stat(path, states[path]);
+    if (QFile::exists(path)) {
+        watcher.addPath(path);
+        if (compareContents) {
+            startHash(path, false);
+        }
+    }
+    watchDirectory(path);
+}
+
+void SlideFileWatcher::removeFile(const QString& fileName)
+{
+    QString path = QFileInfo(fileName).absoluteFilePath();
+    if (!states.remove(path)) {
+        return;
+    }
+    pending.remove(path);
+    watcher.removePath(path);
+    QString directory = QFileInfo(path).absolutePath();
+    if (--directories[directory] == 0) {
+        directories.remove(directory);
+        watcher.removePath(directory);
+    }
+}
+
+QStringList SlideFileWatcher::files() const
+{
+    return states.keys();
+}
+
+QByteArray SlideFileWatcher::contentHash(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    while (!file.atEnd()) {
+        hash.addData(file.read(64 * 1024));
+    }
+    return hash.result();
+}
+
+void SlideFileWatcher::waitForHashes()
+{
+    while (!hashJobs.isEmpty()) {
+        QFutureWatcher<QByteArray>* job = hashJobs.constBegin().key();
+        job->waitForFinished();
+        finishHash(job);
+    }
+}
+
+void SlideFileWatcher::checkFiles()
+{
+    debounce.stop();
+    pending.clear();
+    QStringList paths = states.keys();
+    for (int i = 0; i < paths.size(); ++i) {
+        check(paths.at(i));
+    }
+}
+
+void SlideFileWatcher::fileNotice(const QString& path)
+{
+    schedule(path);
+}
+
+// a file was created, removed or renamed in the directory; look at the
+// watched files in it that have been replaced or are not watched
+void SlideFileWatcher::directoryNotice(const QString& path)
+{
+    QStringList watched = watcher.files();
+    QHash<QString, FileState>::const_iterator i = states.constBegin();
+    for (; i != states.constEnd(); ++i) {
+        if (QFileInfo(i.key()).absolutePath() == path &&
+                !watched.contains(i.key())) {
+            schedule(i.key());
+        }
+    }
+}
+
+// the timer is not restarted by later notices, so a file is checked at
+// most debounceTime after it first changed
+void SlideFileWatcher::schedule(const QString& fileName)
+{
+    if (!states.contains(fileName)) {
+        return;
+    }
+    pending.insert(fileName);
+    if (!debounce.isActive()) {
+        debounce.start();
+    }
+}
+
+void SlideFileWatcher::checkPending()
+{
+    QSet<QString> paths = pending;
+    pending.clear();
+    QSet<QString>::const_iterator i = paths.constBegin();
+    for (; i != paths.constEnd(); ++i) {
+        check(*i);
+    }
+}
+
+void SlideFileWatcher::check(const QString& fileName)
+{
+    // half way through a rename the file may not be there; the directory
+    // notice for its return brings it back here
+    if (!QFile::exists(fileName)) {
+        return;
+    }
+    // a renamed over file has dropped out of the watch list
+    if (!watcher.files().contains(fileName)) {
+        watcher.addPath(fileName);
+    }
+    FileState current;
+    stat(fileName, current);
+    FileState& last = states[fileName];
+    if (current.size == last.size && current.modified == last.modified) {
+        return;
+    }
+    const bool sameSize = current.size == last.size;
+    last.size = current.size;
+    last.modified = current.modified;
+    if (!compareContents) {
+        emit fileChanged(fileName);
+        return;
+    }
+    // only a hash tells whether a file saved at the same size changed
+    if (sameSize && !last.hash.isEmpty()) {
+        startHash(fileName, true);
+        return;
+    }
+    last.hash.clear();
+    startHash(fileName, false);
+    emit fileChanged(fileName);
+}
+
+void SlideFileWatcher::watchDirectory(const QString& fileName)
+{
+    QString directory = QFileInfo(fileName).absolutePath();
+    if (directories[directory]++ == 0) {
+        watcher.addPath(directory);
+    }
+}
+
+void SlideFileWatcher::startHash(const QString& fileName, bool report)
+{
+    FileState& state = states[fileName];
+    HashJob hashJob = { fileName, ++state.hashJob, report };
+    QFutureWatcher<QByteArray>* job = new QFutureWatcher<QByteArray>(this);
+    hashJobs.insert(job, hashJob);
+    connect(job, SIGNAL(finished()), this, SLOT(hashFinished()));
+    job->setFuture(QtConcurrent::run(contentHash, fileName));
+}
+
+void SlideFileWatcher::hashFinished()
+{
+    QFutureWatcher<QByteArray>* job =
+            static_cast<QFutureWatcher<QByteArray>*>(sender());
+    if (hashJobs.contains(job)) {
+        finishHash(job);
+    }
+}
+
+// hashes overtaken by a later one, or for files no longer watched, are
+// dropped
+void SlideFileWatcher::finishHash(QFutureWatcher<QByteArray>* job)
+{
+    const HashJob hashJob = hashJobs.take(job);
+    job->deleteLater();
+    QHash<QString, FileState>::iterator state =
+            states.find(hashJob.fileName);
+    if (state == states.end() || state->hashJob != hashJob.id) {
+        return;
+    }
+    const QByteArray hash = job->result();
+    const QByteArray previous = state->hash;
+    state->hash = hash;
+    if (hashJob.report && !hash.isEmpty() && hash != previous) {
+        emit fileChanged(hashJob.fileName);
+    }
+}
+
+void SlideFileWatcher::stat(const QString& fileName, FileState& state)
+{
+    QFileInfo info(fileName);
+    if (!info.exists()) {
+        state.size = -1;
+        state.modified = -1;
+        return;
+    }
+    state.size = info.size();
+    state.modified = info.lastModified().toMSecsSinceEpoch();
+}
+
+}   // namespace pointy
@@ -0,0 +1,121 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_FILE_WATCHER_H
+#define SLIDE_FILE_WATCHER_H
+
+#include <qbytearray.h>
+#include <qfilesystemwatcher.h>
+#include <qfuturewatcher.h>
+#include <qhash.h>
+#include <qobject.h>
+#include <qset.h>
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qtimer.h>
+
+namespace pointy {
+
+// Reports files whose contents have changed on disk.  Change notices from
+// QFileSystemWatcher are gathered for debounceTime msec after the first
+// one, so an editor that writes a file several times in a row causes a
+// single check.  The file's directory is watched as well: an editor that
+// saves by renaming a new file over the old one replaces the watched
+// inode, and the file is watched again once it reappears.
+//
+// A check only looks at the file's size and modification time.  A new
+// size is reported at once.  A new time with the same size is reported
+// only if a hash of the contents, taken on a worker thread, differs from
+// the last one, so saving a file unchanged does not reload it.  Without
+// compareContents, any new size or time is reported.
+class SlideFileWatcher: public QObject
+{
+    Q_OBJECT
+public:
+    explicit SlideFileWatcher(QObject* parent = 0);
+
+    static const int debounceTime = 100;    // msec
+
+    // the default; otherwise size and modification time are compared
+    void setCompareContents(bool compare);
+
+    void addFile(const QString& fileName);
+    void removeFile(const QString& fileName);
+    QStringList files() const;
+
+    // empty if the file can not be read
+    static QByteArray contentHash(const QString& fileName);
+
+    // blocks until the hashes being taken are done, and handles them
+    void waitForHashes();
+
+signals:
+    void fileChanged(const QString& fileName);
+
+public slots:
+    // compare every file's size and time now, without waiting for a
+    // change notice
+    void checkFiles();
+
+private slots:
+    void fileNotice(const QString& path);
+    void directoryNotice(const QString& path);
+    void checkPending();
+    void hashFinished();
+
+private:
+    struct FileState
+    {
+        FileState(): size(-1), modified(-1), hashJob(0) {}
+
+        qint64 size;
+        qint64 modified;        // msec since the epoch
+        QByteArray hash;        // of the contents at size and modified
+        int hashJob;            // the latest hash asked for
+    };
+
+    struct HashJob
+    {
+        QString fileName;
+        int id;
+        bool report;            // emit fileChanged() if the hash differs
+    };
+
+    void check(const QString& fileName);
+    void schedule(const QString& fileName);
+    void watchDirectory(const QString& fileName);
+    void startHash(const QString& fileName, bool report);
+    void finishHash(QFutureWatcher<QByteArray>* job);
+    static void stat(const QString& fileName, FileState& state);
+
+    QFileSystemWatcher watcher;
+    QTimer debounce;
+    QHash<QString, FileState> states;       // absolute path -> state
+    QHash<QString, int> directories;        // path -> files watched in it
+    QSet<QString> pending;
+    QHash<QFutureWatcher<QByteArray>*, HashJob> hashJobs;
+    bool compareContents;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_FILE_WATCHER_H
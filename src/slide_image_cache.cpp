@@ -0,0 +1,194 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_image_cache.h"
+#include <qdir.h>
+#include <qimagereader.h>
+#include <qrunnable.h>
+
+namespace pointy {
+
+class ImagePrefetch: public QRunnable
+{
+public:
+    ImagePrefetch(SlideImageCache* cache, const QString& key,
+                  const QString& media, const QSize& size):
+        cache(cache), key(key), media(media), size(size)
+    {}
+
+    void run()
+    {
+        cache->load(key, media, size);
+    }
+
+private:
+    SlideImageCache* cache;
+    QString key;
+    QString media;
+    QSize size;
+};
+
+SlideImageCache::SlideImageCache(const QString& baseDir, int budget):
+    baseDir(baseDir), images(budget)
+{
+    // leave cores for the GUI and render threads
+    workers.setMaxThreadCount(2);
+}
+
+SlideImageCache::~SlideImageCache()
+{
+    workers.waitForDone();
+}
+
+QString SlideImageCache::filePath(const QString& media) const
+{
+    return QDir::cleanPath(QDir(baseDir).absoluteFilePath(media));
+}
+
+// Keyed by the file's absolute path, so that every view, window and
+// thumbnail asking for the same file at the same size shares one image
+QString SlideImageCache::cacheKey(const QString& media,
+                                  const QSize& size) const
+{
+    const QString path = filePath(media);
+    if (size.isEmpty()) {
+        return path;        // full resolution
+    }
+    return QString("%1x%2:%3").arg(size.width()).arg(size.height())
+            .arg(path);
+}
+
+QImage SlideImageCache::image(const QString& media, const QSize& size)
+{
+    const QString key = cacheKey(media, size);
+    {
+        QMutexLocker locker(&mutex);
+        while (pending.contains(key)) {
+            decoded.wait(&mutex);
+        }
+        if (const QImage* cached = images.object(key)) {
+            return *cached;
+        }
+        pending.insert(key);
+    }
+    return load(key, media, size);
+}
+
+// Decodes media on a worker thread, unless it is cached or on its way
+void SlideImageCache::prefetch(const QString& media, const QSize& size)
+{
+    const QString key = cacheKey(media, size);
+    {
+        QMutexLocker locker(&mutex);
+        if (pending.contains(key) || images.contains(key)) {
+            return;
+        }
+        pending.insert(key);
+    }
+    workers.start(new ImagePrefetch(this, key, media, size));
+}
+
+bool SlideImageCache::contains(const QString& media, const QSize& size) const
+{
+    QMutexLocker locker(&mutex);
+    return images.contains(cacheKey(media, size));
+}
+
+// drops every decoded size of media; images being decoded are kept
+void SlideImageCache::evict(const QString& media)
+{
+    const QString path = filePath(media);
+    const QString sizedSuffix = ":" + path;
+    QMutexLocker locker(&mutex);
+    const QList<QString> keys = images.keys();
+    for (int i = 0; i < keys.size(); ++i) {
+        if (keys.at(i) == path || keys.at(i).endsWith(sizedSuffix)) {
+            images.remove(keys.at(i));
+        }
+    }
+}
+
+void SlideImageCache::setBudget(int budget)
+{
+    QMutexLocker locker(&mutex);
+    images.setMaxCost(budget);
+}
+
+int SlideImageCache::budget() const
+{
+    QMutexLocker locker(&mutex);
+    return images.maxCost();
+}
+
+int SlideImageCache::cost() const
+{
+    QMutexLocker locker(&mutex);
+    return images.totalCost();
+}
+
+// key must already be in pending; it is removed once the image is cached
+QImage SlideImageCache::load(const QString& key, const QString& media,
+                             const QSize& size)
+{
+    QImage result = decode(media, size);
+
+    QMutexLocker locker(&mutex);
+    pending.remove(key);
+    if (!result.isNull()) {
+        // images larger than the whole budget are returned, not cached
+        images.insert(key, new QImage(result),
+                      qMax(1, result.byteCount() / 1024));
+    }
+    decoded.wakeAll();
+    return result;
+}
+
+QImage SlideImageCache::decode(const QString& media, const QSize& size) const
+{
+    QImageReader reader(filePath(media));
+    const QSize fullSize = reader.size();
+    if (!size.isEmpty() && fullSize.isValid()) {
+        // cover the whole target, so cropping fill modes stay sharp; the
+        // JPEG decoder can then skip most of the work for large photos
+        QSize scaledSize = fullSize.scaled(size,
+                                           Qt::KeepAspectRatioByExpanding);
+        if (scaledSize.width() < fullSize.width()) {
+            reader.setScaledSize(scaledSize);
+        }
+    }
+    QImage result = reader.read();
+    if (result.isNull()) {
+        qWarning("Can not read image %s: %s", qPrintable(media),
+                 qPrintable(reader.errorString()));
+        return result;
+    }
+    // the formats the scene graph uploads as they are; converting here, on
+    // the decoding thread, means views share these pixels instead of
+    // each converting a copy
+    const QImage::Format format = result.hasAlphaChannel() ?
+                QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+    if (result.format() != format) {
+        result = result.convertToFormat(format);
+    }
+    return result;
+}
+
+}   // namespace pointy
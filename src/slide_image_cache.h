@@ -0,0 +1,81 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_IMAGE_CACHE_H
+#define SLIDE_IMAGE_CACHE_H
+
+#include <qcache.h>
+#include <qimage.h>
+#include <qmutex.h>
+#include <qset.h>
+#include <qsize.h>
+#include <qstring.h>
+#include <qthreadpool.h>
+#include <qwaitcondition.h>
+
+namespace pointy {
+
+// The process wide registry of decoded slide images, shared by every
+// window and by the thumbnailer.  Images are decoded at the size they are
+// shown at and kept in a least recently used cache limited to a budget in
+// KiB; an empty size decodes the image at full resolution.  Safe to use
+// from the QML image loader thread and worker threads at the same time;
+// an image is never decoded twice at once.
+class SlideImageCache
+{
+public:
+    explicit SlideImageCache(const QString& baseDir,
+                             int budget = defaultBudget);
+    ~SlideImageCache();
+
+    static const int defaultBudget = 256 * 1024;    // KiB
+
+    QImage image(const QString& media, const QSize& size);
+    void prefetch(const QString& media, const QSize& size);
+    bool contains(const QString& media, const QSize& size) const;
+    void evict(const QString& media);
+    QString filePath(const QString& media) const;
+
+    void setBudget(int budget);
+    int budget() const;
+    int cost() const;
+
+private:
+    Q_DISABLE_COPY(SlideImageCache)
+
+    friend class ImagePrefetch;
+
+    QString cacheKey(const QString& media, const QSize& size) const;
+    QImage load(const QString& key, const QString& media, const QSize& size);
+    QImage decode(const QString& media, const QSize& size) const;
+
+    QString baseDir;
+    mutable QMutex mutex;
+    QWaitCondition decoded;
+    QCache<QString, QImage> images;
+    QSet<QString> pending;
+    QThreadPool workers;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_IMAGE_CACHE_H
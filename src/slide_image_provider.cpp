@@ -0,0 +1,113 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_image_provider.h"
+#include "slide_image_cache.h"
+#include "slide_media_kind.h"
+#include "slide_list_model.h"
+#include "slide_residency.h"
+#include "slide_video_probe.h"
+#include <qurl.h>
+
+namespace pointy {
+
+SlideImageProvider::SlideImageProvider(SlideImageCache* cache):
+    QQuickImageProvider(QQuickImageProvider::Image,
+                        QQuickImageProvider::ForceAsynchronousImageLoading),
+    cache(cache)
+{}
+
+// the leading revision only makes the URL of a replaced file a new one
+QImage SlideImageProvider::requestImage(const QString& id, QSize* size,
+                                        const QSize& requestedSize)
+{
+    const QString media = QUrl::fromPercentEncoding(
+                id.section('/', 1).toUtf8());
+    QImage image = cache->image(media, requestedSize);
+    if (size) {
+        *size = image.size();
+    }
+    return image;
+}
+
+VideoPosterProvider::VideoPosterProvider(SlideVideoProbe* probe):
+    QQuickImageProvider(QQuickImageProvider::Image,
+                        QQuickImageProvider::ForceAsynchronousImageLoading),
+    probe(probe)
+{}
+
+QImage VideoPosterProvider::requestImage(const QString& id, QSize* size,
+                                         const QSize& requestedSize)
+{
+    QImage poster = probe->poster(QUrl::fromPercentEncoding(id.toUtf8()));
+    if (!poster.isNull() && requestedSize.isValid()) {
+        poster = poster.scaled(requestedSize, Qt::KeepAspectRatioByExpanding,
+                               Qt::SmoothTransformation);
+    }
+    if (size) {
+        *size = poster.size();
+    }
+    return poster;
+}
+
+SlideImagePrefetcher::SlideImagePrefetcher(SlideImageCache* cache,
+                                           SlideListModel* model,
+                                           QObject* parent):
+    QObject(parent), cache(cache), model(model), residency(0), distance(2)
+{}
+
+void SlideImagePrefetcher::setDistance(int slides)
+{
+    distance = slides;
+}
+
+void SlideImagePrefetcher::setResidency(const SlideResidency* residency)
+{
+    this->residency = residency;
+}
+
+// nearest slides first, so they are decoded first
+void SlideImagePrefetcher::prefetchAround(int row, int width, int height)
+{
+    const QSize windowSize(width, height);
+    for (int offset = 0; offset <= distance; ++offset) {
+        const int rows[] = { row + offset, row - offset };
+        for (int i = 0; i < (offset ? 2 : 1); ++i) {
+            QModelIndex slide = model->index(rows[i]);
+            if (!slide.isValid() ||
+                    (residency && !residency->isResident(rows[i]))) {
+                continue;
+            }
+            QString media = model->data(slide, SlideListModel::SlideMediaRole)
+                    .toString();
+            if (mediaKind(media) != StillImage) {
+                continue;
+            }
+            // unscaled slides show the image at its own size
+            bool unscaled = model->data(slide,
+                                        SlideListModel::BackgroundScaleRole)
+                    .toInt() == SlideEnums::Unscaled;
+            cache->prefetch(media, unscaled ? QSize() : windowSize);
+        }
+    }
+}
+
+}   // namespace pointy
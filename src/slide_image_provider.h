@@ -0,0 +1,90 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_IMAGE_PROVIDER_H
+#define SLIDE_IMAGE_PROVIDER_H
+
+#include <QtQuick/qquickimageprovider.h>
+#include <qobject.h>
+
+namespace pointy {
+
+class SlideImageCache;
+class SlideListModel;
+class SlideResidency;
+class SlideVideoProbe;
+
+// Serves "image://slides/<revision>/<media>" from a SlideImageCache, with
+// the media name percent-encoded.  The requested size is the Image's
+// sourceSize, so slides are decoded at window size.
+class SlideImageProvider: public QQuickImageProvider
+{
+public:
+    explicit SlideImageProvider(SlideImageCache* cache);
+
+    QImage requestImage(const QString& id, QSize* size,
+                        const QSize& requestedSize);
+
+private:
+    SlideImageCache* cache;
+};
+
+// Serves "image://posters/<media>", the first frame of a video slide,
+// once SlideVideoProbe has opened the video.
+class VideoPosterProvider: public QQuickImageProvider
+{
+public:
+    explicit VideoPosterProvider(SlideVideoProbe* probe);
+
+    QImage requestImage(const QString& id, QSize* size,
+                        const QSize& requestedSize);
+
+private:
+    SlideVideoProbe* probe;
+};
+
+// Decodes the images of the slides around the current one ahead of time,
+// so that moving to the next slide does not wait on the decoder.
+class SlideImagePrefetcher: public QObject
+{
+    Q_OBJECT
+public:
+    SlideImagePrefetcher(SlideImageCache* cache, SlideListModel* model,
+                         QObject* parent = 0);
+
+    void setDistance(int slides);
+    // only slides the residency allows to hold media are prefetched
+    void setResidency(const SlideResidency* residency);
+
+public slots:
+    void prefetchAround(int row, int width, int height);
+
+private:
+    SlideImageCache* cache;
+    SlideListModel* model;
+    const SlideResidency* residency;
+    int distance;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_IMAGE_PROVIDER_H
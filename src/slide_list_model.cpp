@@ -22,18 +22,28 @@
 
 #include "slide_list_model.h"
 #include "slide_data.h"
+#include "pin_tokenizer.h"
+#include "slide_file_buffer.h"
+#include "slide_deck_cache.h"
 #include <QtCore/QtCore>
 #include <QMessageLogger>
 #include <qregexp.h>
 #include <qhash.h>
 #include <qcolor.h>
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
 
 
 namespace pointy {
 
-SlideListModel::SlideListModel(QObject *parent) : QAbstractListModel(parent)
+SlideListModel::SlideListModel(QObject *parent) : QAbstractListModel(parent),
+    lazyRows(defaultCachedSlides), reloadPending(false)
 {
     customSlideSettings = QSharedPointer<SlideData>(new SlideData);
+    connect(&deckWatcher, SIGNAL(finished()), this, SLOT(slideDeckLoaded()));
 
 }
 
@@ -43,57 +53,72 @@ QVariant SlideListModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();      // return a Null variant
 
-    if (index.row() >= slideList.size() )
+    if (role == FittedFontSizeRole && index.row() < rowCount()) {
+        return textFitter.pixelSize(*slideAt(index.row()), slideSize);
+    }
+    if (role == MediaRevisionRole && index.row() < rowCount()) {
+        return mediaRevisions.value(data(index, SlideMediaRole).toString());
+    }
+    const int column = role - FirstSlideRole;
+    if (column < 0 || column >= SlideRoleCount ||
+            index.row() >= rowCount())
         return QVariant();
 
-    const QSharedPointer<SlideData> currentSlide = slideList.at(index.row());
+    if (lazyDeck) {
+        return lazyRow(index.row()).values.at(column);
+    }
+    return columns[column].at(index.row());
+}
+
+QVariant SlideListModel::roleValue(const SlideData& slide, int role)
+{
     switch (role) {
     case StageColorRole:
-        return QVariant::fromValue(currentSlide->stageColor);
+        return QVariant::fromValue(slide.style().stageColor);
     case FontRole:
-        return QVariant::fromValue(currentSlide->font);
+        return QVariant::fromValue(slide.style().font);
     case FontSizeRole:
-        return QVariant::fromValue(currentSlide->fontSize);
+        return QVariant::fromValue(slide.style().fontSize);
     case FontSizeUnitRole:
-        return QVariant::fromValue(currentSlide->fontSizeUnit);
+        return QVariant::fromValue(slide.style().fontSizeUnit);
     case NotesFontRole:
-        return QVariant::fromValue(currentSlide->notesFont);
+        return QVariant::fromValue(slide.style().notesFont);
     case NotesFontSizeRole:
-        return QVariant::fromValue(currentSlide->notesFontSize);
+        return QVariant::fromValue(slide.style().notesFontSize);
     case TextColorRole:
-        return QVariant::fromValue(currentSlide->textColor);
+        return QVariant::fromValue(slide.style().textColor);
     case TextAlignRole:
-        return QVariant::fromValue(currentSlide->textAlign);
+        return QVariant(int(slide.style().textAlign));
     case ShadingColorRole:
-        return QVariant::fromValue(currentSlide->shadingColor);
+        return QVariant::fromValue(slide.style().shadingColor);
     case ShadingOpacityRole:
-        return QVariant::fromValue(currentSlide->shadingOpacity);
+        return QVariant::fromValue(slide.style().shadingOpacity);
     case DurationRole:
-        return QVariant::fromValue(currentSlide->duration);
+        return QVariant::fromValue(slide.style().duration);
     case CommandRole:
-        return QVariant::fromValue(currentSlide->command);
+        return QVariant::fromValue(slide.command);
     case TransitionRole:
-        return QVariant::fromValue(currentSlide->transition);
+        return QVariant(int(slide.style().transition));
     case CameraFrameRateRole:
-        return QVariant::fromValue(currentSlide->cameraFrameRate);
+        return QVariant::fromValue(slide.style().cameraFrameRate);
     case BackgroundScaleRole:
-        return QVariant::fromValue(currentSlide->backgroundScale);
+        return QVariant(int(slide.style().backgroundScale));
     case PositionRole:
-        return QVariant::fromValue(currentSlide->position);
+        return QVariant(int(slide.style().position));
     case UseMarkupRole:
-        return QVariant::fromValue(currentSlide->useMarkup);
+        return QVariant::fromValue(slide.style().useMarkup);
     case SlideTextRole:
-        return QVariant::fromValue(currentSlide->slideText);
+        return QVariant::fromValue(slide.slideText);
     case MaxLineLengthRole:
-        return QVariant::fromValue(currentSlide->maxLineLength);
+        return QVariant::fromValue(slide.maxLineLength);
     case SlideMediaRole:
-        return QVariant::fromValue(currentSlide->slideMedia);
+        return QVariant::fromValue(slide.slideMedia);
     case BackgroundColorRole:
-        return QVariant::fromValue(currentSlide->backgroundColor);
+        return QVariant::fromValue(slide.style().backgroundColor);
     case NotesTextRole:
-        return QVariant::fromValue(currentSlide->notesText);
+        return QVariant::fromValue(slide.notesText);
     case SlideNumberRole:
-        return QVariant::fromValue(currentSlide->slideNumber);
+        return QVariant::fromValue(slide.slideNumber);
     default:
         return QVariant();
     }
@@ -101,10 +126,20 @@ QVariant SlideListModel::data(const QModelIndex &index, int role) const
 
 int SlideListModel::rowCount(const QModelIndex& parent) const
 {
+    if (lazyDeck) {
+        return lazyDeck->size();
+    }
     return slideList.size();
 }
 
 QHash<int, QByteArray> SlideListModel::roleNames() const
+{
+    // views ask for the role names on every delegate they create
+    static const QHash<int, QByteArray> roles = buildRoleNames();
+    return roles;
+}
+
+QHash<int, QByteArray> SlideListModel::buildRoleNames()
 {
     QHash<int, QByteArray> roles;
     roles[StageColorRole] = "stageColor";
@@ -130,6 +165,8 @@ QHash<int, QByteArray> SlideListModel::roleNames() const
     roles[BackgroundColorRole] ="backgroundColor";
     roles[NotesTextRole] = "notesText";
     roles[SlideNumberRole] = "slideNumber";
+    roles[FittedFontSizeRole] = "fittedFontSize";
+    roles[MediaRevisionRole] = "mediaRevision";
     return roles;
 
 }
@@ -142,59 +179,56 @@ void stripComments(QSharedPointer<QByteArray>& lineIn,
     {
         return;
     }
-    int commentIndex = lineIn->indexOf(comment);
-    if (commentIndex == -1) {
-        // no comment in line
+    const QByteArray marker = comment.toUtf8();
+    int searchFrom = 0;
+    int commentIndex;
+    while ((commentIndex = lineIn->indexOf(marker, searchFrom)) != -1) {
+        if (commentIndex > 0 && lineIn->at(commentIndex - 1) == '\\') {
+            // escaped comment, drop the backslash and keep looking
+            lineIn->remove(commentIndex - 1, 1);
+            searchFrom = commentIndex - 1 + marker.size();
+            continue;
+        }
+        commentStore->append(lineIn->mid(commentIndex + marker.size()));
+        lineIn->truncate(commentIndex);
         return;
     }
-    else if (commentIndex == 0) {
-        // comment at start of line
-        commentStore->append(lineIn->mid(1));
-        lineIn->clear();
-    }
-    else if (lineIn->at(commentIndex-1) == '\\'){
-        // recursively check for escaped comments and actual comments
-        QSharedPointer<QByteArray> remains =
-                QSharedPointer<QByteArray>(new QByteArray);
-        *remains = (lineIn->mid(commentIndex + 1));
-        stripComments(remains, commentStore);
-        *lineIn = (lineIn->left(commentIndex - 1)).append("#"). // removes '\\'
-                append(*remains);
-    }
-    else {
-        commentStore->append(lineIn->mid(commentIndex+1));
-        *lineIn = (lineIn->left(commentIndex));
-    }
 }
 
 void stripSquareBrackets(QSharedPointer<QByteArray>& lineIn,
                          QSharedPointer<QStringList>& store,
                          const int& lineCount)
 {
-    int numberStartBracket = lineIn->count("[");
-    int numberEndBracket = lineIn->count("]");
-    if (numberStartBracket != numberEndBracket)
-    {
-        qWarning("Line %d: incomplete brackets", lineCount);
-        return;
-    }
-    int startBracket = lineIn->indexOf("[");
-    if (startBracket < 0) {
-        return;
-    }
+    int numberStartBracket = lineIn->count('[');
+    int numberEndBracket = lineIn->count(']');
+    int searchFrom = 0;
+    forever {
+        if (numberStartBracket != numberEndBracket)
+        {
+            qWarning("Line %d: incomplete brackets", lineCount);
+            return;
+        }
+        int startBracket = lineIn->indexOf('[', searchFrom);
+        if (startBracket < 0) {
+            return;
+        }
 
-    int endBracket = lineIn->indexOf("]");
-    if (endBracket < startBracket) {
-        qWarning("Line %d: mismatched brackets", lineCount);
-        return;
+        int endBracket = lineIn->indexOf(']', searchFrom);
+        if (endBracket < startBracket) {
+            qWarning("Line %d: mismatched brackets", lineCount);
+            return;
+        }
+        store->append(QString::fromUtf8(lineIn->constData() + startBracket + 1,
+                                        endBracket - (startBracket + 1)));
+        // carry on with the remainder of the line for additional settings
+        for (int i = searchFrom; i < endBracket; ++i) {
+            if (lineIn->at(i) == '[') {
+                --numberStartBracket;
+            }
+        }
+        --numberEndBracket;
+        searchFrom = endBracket + 1;
     }
-    QSharedPointer<QByteArray> remains =
-            QSharedPointer<QByteArray>(new QByteArray);
-    *remains = (lineIn->mid(endBracket + 1));
-    store->append(lineIn->mid(startBracket + 1, endBracket-(startBracket+1)));
-    // recursive search for additional settings on the line
-    stripSquareBrackets(remains,
-                        store, lineCount);
 }
 
 void populateSlideSettings(QStringList &listIn,
@@ -243,141 +277,847 @@ void findMaxLineLength(QSharedPointer<QByteArray>& lineIn, int &lineLength)
 }
 
 
-void SlideListModel::readSlideFile(const QString fileName)
+namespace {
+
+int trimmedLength(const QByteArray& text, int from)
+{
+    const char* begin = text.constData() + from;
+    const char* end = text.constData() + text.size();
+    while (begin < end && isspace(uchar(*begin))) {
+        ++begin;
+    }
+    while (end > begin && isspace(uchar(end[-1]))) {
+        --end;
+    }
+    return end - begin;
+}
+
+uint hashBlock(const char* begin, const char* end, uint seed)
 {
-    int lineCount = 0;      // for error reporting
-    bool haveCustomSettings = false;
+    return qHash(QByteArray::fromRawData(begin, end - begin), seed);
+}
 
-    currentFileName = fileName;  // stored for reloading if needed later
+// Collects the settings, text and notes of one slide, or of the header,
+// from its tokens.
+class SlideBuilder
+{
+public:
+    explicit SlideBuilder(const QSharedPointer<SlideData>& slide):
+        slide(slide), lineLength(0), lineStart(0), isSlideLine(false)
+    {}
+
+    void addToken(const PinToken& token)
+    {
+        switch (token.type) {
+        case PinToken::SlideStart:
+            isSlideLine = true;
+            break;
+        case PinToken::Setting:
+            rawSettingsList.append(token.toString());
+            break;
+        case PinToken::Comment:
+            notesText.append(token.begin, token.length);
+            break;
+        case PinToken::Text:
+            slideText.append(token.begin, token.length);
+            break;
+        case PinToken::LineEnd:
+            if (isSlideLine) {
+                populateSlideSettings(rawSettingsList, slide);
+                rawSettingsList.clear();
+                isSlideLine = false;
+            }
+            else {
+                lineLength = qMax(lineLength,
+                                  trimmedLength(slideText, lineStart));
+            }
+            lineStart = slideText.size();
+            break;
+        }
+    }
+
+    void finish()
+    {
+        // header settings are only applied once the header is complete
+        populateSlideSettings(rawSettingsList, slide);
+        if (slideText.isEmpty()) {
+            return;
+        }
+        slide->slideText = QString::fromUtf8(slideText).trimmed();
+        slide->notesText = QString::fromUtf8(notesText).trimmed();
+        if (lineLength > 0) {
+            slide->maxLineLength = lineLength;
+        }
+    }
+
+private:
+    QSharedPointer<SlideData> slide;
+    QStringList rawSettingsList;
+    QByteArray slideText;
+    QByteArray notesText;
+    int lineLength;
+    int lineStart;
+    bool isSlideLine;
+};
+
+// One "--" slide, from its first line up to the next slide
+struct SlideBlock
+{
+    const char* begin;
+    const char* end;
+    int firstLine;
+    QSharedPointer<SlideData> slide;
+};
+
+// Finds the "--" lines with a plain scan of the buffer, counting lines the
+// way PinTokenizer does.
+void findSlideBlocks(const char* data, int size, QVector<SlideBlock>& blocks)
+{
+    const char* end = data + size;
+    const char* line = data;
+    int lineCount = 0;
+    while (line < end) {
+        const char* newline =
+                static_cast<const char*>(memchr(line, '\n', end - line));
+        const char* nextLine = newline ? newline + 1 : end;
+        if (nextLine - line >= 2) {
+            if (lineCount == 0 && line[0] == '#' && line[1] == '!') {
+                line = nextLine;
+                continue;
+            }
+            if (line[0] == '-' && line[1] == '-') {
+                if (!blocks.isEmpty()) {
+                    blocks.last().end = line;
+                }
+                SlideBlock block = { line, end, lineCount,
+                                     QSharedPointer<SlideData>() };
+                blocks.append(block);
+            }
+        }
+        ++lineCount;
+        line = nextLine;
+    }
+}
+
+// Slides only depend on the header settings and their own block, so blocks
+// may be parsed in any order, on any thread.
+class SlideBlockParser
+{
+public:
+    typedef void result_type;
+
+    SlideBlockParser(const SlideData& customSlideSettings, uint headerHash):
+        customSlideSettings(customSlideSettings), headerHash(headerHash)
+    {}
+
+    void operator()(SlideBlock& block) const
+    {
+        block.slide = QSharedPointer<SlideData>(
+                    new SlideData(customSlideSettings));
+        // every slide block is hashed together with the header, which all
+        // slides inherit from, so that reloads can tell which slides changed
+        block.slide->blockHash =
+                hashBlock(block.begin, block.end, headerHash);
 
+        SlideBuilder builder(block.slide);
+        PinTokenizer tokenizer(block.begin, block.end - block.begin, false,
+                               block.firstLine);
+        PinToken token;
+        while (tokenizer.next(token)) {
+            builder.addToken(token);
+        }
+        builder.finish();
+    }
+
+private:
+    SlideData customSlideSettings;
+    uint headerHash;
+};
+
+// below this, starting worker threads costs more than it saves
+const int parallelSlideThreshold = 64;
+
+// Parses the text and settings before the first slide into header, which
+// every slide starts from, and returns the hash slide blocks are seeded with.
+uint parseHeader(const char* data, const char* headerEnd,
+                 const QSharedPointer<SlideData>& header)
+{
+    SlideBuilder headerBuilder(header);
+    PinTokenizer tokenizer(data, headerEnd - data);
+    PinToken token;
+    while (tokenizer.next(token)) {
+        headerBuilder.addToken(token);
+    }
+    headerBuilder.finish();
+    return hashBlock(data, headerEnd, 0);
+}
+
+// Reloads that insert, remove or move most rows reset the views instead,
+// as do reorderings with more moves than this, since each move shifts
+// the role values.
+const int minResetRows = 64;
+const int maxMovedRows = 64;
+
+// One step in turning the old slide list into the new one.  row is in the
+// list as it stands when the step is taken.
+struct SlideEdit
+{
+    enum Type {
+        Insert,         // newSlides [first, first + count) at row
+        Change,         // rows [row, row + count) edited in place
+        Move            // the row at from moved up to row
+    };
+
+    Type type;
+    int row;
+    int from;
+    int first;
+    int count;
+};
+
+// adjacent inserts, and adjacent edits in place, become one step
+void addEdit(QVector<SlideEdit>& edits, SlideEdit::Type type, int row,
+             int first)
+{
+    if (!edits.isEmpty()) {
+        SlideEdit& last = edits.last();
+        if (last.type == type && last.row + last.count == row &&
+                last.first + last.count == first) {
+            ++last.count;
+            return;
+        }
+    }
+    SlideEdit edit = { type, row, -1, first, 1 };
+    edits.append(edit);
+}
+
+// Counts the old rows not yet placed, so that an old row's position in
+// the list being edited is found in O(log n).
+class UnplacedRows
+{
+public:
+    explicit UnplacedRows(int size): tree(size + 1, 0)
+    {
+        for (int i = 1; i <= size; ++i) {
+            ++tree[i];
+            const int parent = i + (i & -i);
+            if (parent <= size) {
+                tree[parent] += tree[i];
+            }
+        }
+    }
+
+    void place(int row)
+    {
+        for (int i = row + 1; i < tree.size(); i += i & -i) {
+            --tree[i];
+        }
+    }
+
+    // unplaced rows before row
+    int before(int row) const
+    {
+        int count = 0;
+        for (int i = row; i > 0; i -= i & -i) {
+            count += tree.at(i);
+        }
+        return count;
+    }
+
+private:
+    QVector<int> tree;
+};
+
+}   // namespace
+
+void parseSlideBuffer(const char* data, int size,
+                      QList<QSharedPointer<SlideData> >& slides)
+{
+    QVector<SlideBlock> blocks;
+    findSlideBlocks(data, size, blocks);
+    if (blocks.isEmpty()) {
+        return;
+    }
+
+    QSharedPointer<SlideData> customSlideSettings(new SlideData);
+    uint headerHash = parseHeader(data, blocks.first().begin,
+                                  customSlideSettings);
+
+    SlideBlockParser parseBlock(*customSlideSettings, headerHash);
+    if (blocks.size() < parallelSlideThreshold) {
+        for (int i = 0; i < blocks.size(); ++i) {
+            parseBlock(blocks[i]);
+        }
+    }
+    else {
+        QtConcurrent::blockingMap(blocks, parseBlock);
+    }
+
+    // slides that override the same settings end up sharing one style
+    SlideStylePool stylePool;
+    stylePool.intern(*customSlideSettings);
+    slides.reserve(slides.size() + blocks.size());
+    for (int i = 0; i < blocks.size(); ++i) {
+        stylePool.intern(*blocks.at(i).slide);
+        slides.append(blocks.at(i).slide);
+    }
+}
+
+LazySlideDeck::LazySlideDeck():
+    fileSize(0), header(new SlideData), headerHash(0)
+{}
+
+// Scans the file a line at a time, keeping only where slides start; the
+// header, before the first slide, is read back and parsed.
+bool LazySlideDeck::open(const QString& fileName)
+{
+    blocks.clear();
+    header = QSharedPointer<SlideData>(new SlideData);
+    headerHash = 0;
     QFile file(fileName);
     if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    this->fileName = fileName;
+    fileSize = file.size();
+    modified = QFileInfo(file).lastModified();
+
+    // the lines are counted, and "#!" skipped, as findSlideBlocks() does
+    qint64 offset = 0;
+    int lineCount = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.isEmpty()) {
+            break;
+        }
+        const qint64 lineStart = offset;
+        offset += line.size();
+        if (line.size() >= 2) {
+            if (lineCount == 0 && line.startsWith("#!")) {
+                continue;
+            }
+            if (line.startsWith("--")) {
+                if (!blocks.isEmpty()) {
+                    blocks.last().end = lineStart;
+                }
+                Block block = { lineStart, -1, lineCount };
+                blocks.append(block);
+            }
+        }
+        ++lineCount;
+    }
+    if (blocks.isEmpty()) {
+        return true;
+    }
+    blocks.last().end = offset;
+
+    if (!file.seek(0)) {
+        return false;
+    }
+    const QByteArray headerBytes = file.read(blocks.first().begin);
+    const char* data = headerBytes.constData();
+    headerHash = parseHeader(data, data + headerBytes.size(), header);
+    return true;
+}
+
+int LazySlideDeck::size() const
+{
+    return blocks.size();
+}
+
+QSharedPointer<SlideData> LazySlideDeck::slide(int row) const
+{
+    const Block& block = blocks.at(row);
+    QFile file(fileName);
+    QByteArray bytes;
+    if (file.open(QIODevice::ReadOnly) && file.size() == fileSize &&
+            QFileInfo(file).lastModified() == modified &&
+            file.seek(block.begin)) {
+        bytes = file.read(block.end - block.begin);
+    }
+    // changed since it was indexed; the file watcher reloads it
+    if (bytes.size() != block.end - block.begin) {
+        return QSharedPointer<SlideData>(new SlideData(*header));
+    }
+    const char* data = bytes.constData();
+    SlideBlock slideBlock = { data, data + bytes.size(), block.firstLine,
+                              QSharedPointer<SlideData>() };
+    SlideBlockParser parseBlock(*header, headerHash);
+    parseBlock(slideBlock);
+    return slideBlock.slide;
+}
+
+void SlideListModel::readSlideFile(const QString fileName)
+{
+    currentFileName = fileName;  // stored for reloading if needed later
+
+    if (lazyDeck) {
+        if (!loadLazyDeck(fileName)) {
+            qFatal("Slide file can not be read");
+        }
+        return;
+    }
+
+    SlideDeck deck = loadSlideDeck(fileName, deckCacheDir);
+    if (!deck.isValid) {
         qFatal("Slide file can not be read");
     }
+    updateSlides(deck.slides);
+}
 
-    QSharedPointer<QStringList> rawSettingsList = QSharedPointer<QStringList>
-            (new QStringList);
-    newSlideSetting();
-    QSharedPointer<SlideData> currentSlideSettings = slideList.last();
-    QSharedPointer<SlideData> customSlideSettings = slideList.first();
-    QSharedPointer<QString> currentSlideText =
-            QSharedPointer<QString>(new QString);
-    QSharedPointer<QString> currentNotesText =
-            QSharedPointer<QString>(new QString);
-    int lineLength(0);
+SlideDeck loadSlideDeck(const QString& fileName, const QString& cacheDir)
+{
+    SlideDeck deck;
+    SlideFileBuffer file;
+    if (!file.open(fileName)) {
+        return deck;
+    }
+    deck.isValid = true;
 
-    while (!file.atEnd()) {
+    if (cacheDir.isEmpty() || !file.isMapped()) {
+        parseSlideBuffer(file.data(), file.size(), deck.slides);
+        return deck;
+    }
+    // hashed once, here on the loading thread, for the lookup and the write
+    const SlideDeckCache::Key key = SlideDeckCache::sourceKey(fileName, file);
+    SlideDeckCache cache(cacheDir);
+    if (!cache.load(key, deck.slides)) {
+        parseSlideBuffer(file.data(), file.size(), deck.slides);
+        if (!cache.save(key, deck.slides)) {
+            qWarning("Slide cache not written for %s", qPrintable(fileName));
+        }
+    }
+    return deck;
+}
 
-        QSharedPointer<QByteArray> linePtr =
-                QSharedPointer<QByteArray>(new QByteArray);
-        *linePtr = file.readLine();
-        if (lineCount == 0 && linePtr->startsWith("#!"))
-        {
-            continue;
+SlideDeck loadLazySlideDeck(const QString& fileName)
+{
+    SlideDeck deck;
+    deck.lazyDeck = QSharedPointer<LazySlideDeck>(new LazySlideDeck);
+    deck.isValid = deck.lazyDeck->open(fileName);
+    return deck;
+}
+
+// Parsed decks are kept in cacheDir and reused while the source file is
+// unchanged.  An empty cacheDir, the default, disables the cache.
+void SlideListModel::setDeckCacheDir(const QString& cacheDir)
+{
+    deckCacheDir = cacheDir;
+}
+
+// In lazy mode, only the slide boundaries are read up front; each slide is
+// parsed the first time a view asks for it, and at most cachedSlides
+// parsed slides are kept, at least one.  Meant for decks too large to hold
+// in memory.
+void SlideListModel::setLazyLoading(bool lazy, int cachedSlides)
+{
+    cachedSlides = qMax(1, cachedSlides);
+    if (lazy == !lazyDeck.isNull()) {
+        lazyRows.setMaxCost(cachedSlides);
+        return;
+    }
+    beginResetModel();
+    slideList.clear();
+    removeRoleValues(0, columns[0].size());
+    lazyRows.clear();
+    lazyRows.setMaxCost(cachedSlides);
+    lazyDeck = QSharedPointer<LazySlideDeck>(lazy ? new LazySlideDeck : 0);
+    endResetModel();
+}
+
+// Reindexes the file; without parsed slides to compare, views are reset.
+bool SlideListModel::loadLazyDeck(const QString& fileName)
+{
+    const SlideDeck deck = loadLazySlideDeck(fileName);
+    if (!deck.isValid) {
+        return false;
+    }
+    setLazyDeck(deck.lazyDeck);
+    return true;
+}
+
+void SlideListModel::setLazyDeck(const QSharedPointer<LazySlideDeck>& deck)
+{
+    beginResetModel();
+    lazyRows.clear();
+    lazyDeck = deck;
+    endResetModel();
+}
+
+// Returned by value: both members are shared, and the cache may drop the
+// entry as soon as it is inserted.
+SlideListModel::LazyRow SlideListModel::lazyRow(int row) const
+{
+    const LazyRow* cached = lazyRows.object(row);
+    if (cached) {
+        return *cached;
+    }
+    LazyRow parsed;
+    parsed.slide = lazyDeck->slide(row);
+    parsed.values.resize(SlideRoleCount);
+    for (int column = 0; column < SlideRoleCount; ++column) {
+        parsed.values[column] = roleValue(*parsed.slide,
+                                          FirstSlideRole + column);
+    }
+    lazyRows.insert(row, new LazyRow(parsed));
+    return parsed;
+}
+
+// Parses fileName on a worker thread; the slides replace the current ones
+// once parsing has finished.
+void SlideListModel::loadSlideFile(const QString& fileName)
+{
+    currentFileName = fileName;
+    reloadSlides();
+}
+
+// lazy decks are indexed on the worker as well
+void SlideListModel::reloadSlides()
+{
+    if (deckWatcher.isRunning()) {
+        // pick up the latest version of the file once this load is done
+        reloadPending = true;
+        return;
+    }
+    if (lazyDeck) {
+        deckWatcher.setFuture(QtConcurrent::run(loadLazySlideDeck,
+                                                currentFileName));
+    }
+    else {
+        deckWatcher.setFuture(QtConcurrent::run(loadSlideDeck,
+                                                currentFileName,
+                                                deckCacheDir));
+    }
+}
+
+void SlideListModel::slideDeckLoaded()
+{
+    const SlideDeck deck = deckWatcher.result();
+    if (deck.lazyDeck.isNull() != lazyDeck.isNull()) {
+        // lazy loading was switched while the file was read
+        reloadPending = true;
+    }
+    else {
+        if (!deck.isValid) {
+            qWarning("Slide file can not be read");
         }
-        if (linePtr->startsWith("[") && haveCustomSettings == false) {
-            stripComments(linePtr, currentNotesText, "#");
-            stripSquareBrackets(linePtr, rawSettingsList, lineCount);
+        else if (lazyDeck) {
+            setLazyDeck(deck.lazyDeck);
         }
-        else if (linePtr->startsWith("--")) {
-            if (haveCustomSettings == false) {
-                // this is the first slide, so store header custom settings
-                haveCustomSettings = true;
-                populateSlideSettings(*rawSettingsList, customSlideSettings);
-            }
-            if (haveCustomSettings == true) {
-
-                if (!(currentSlideText->isEmpty())) {
-                    *currentSlideText = currentSlideText->trimmed();
-                    currentSlideSettings->slideText = *currentSlideText;
-                    *currentNotesText = currentNotesText->trimmed();
-                    currentSlideSettings->notesText = *currentNotesText;
-                    if (lineLength > 0) {
-                        currentSlideSettings->maxLineLength = lineLength;
-                    }
-                }
+        else {
+            updateSlides(deck.slides);
+        }
+        emit slidesLoaded();
+    }
 
-                newSlideSetting(*customSlideSettings);
-                lineLength = 0;
-                currentSlideSettings = slideList.last();
-                rawSettingsList->clear();
-                currentSlideText->clear();
-                currentNotesText->clear();
-                stripComments(linePtr, currentNotesText, "#");
-            }
+    if (reloadPending) {
+        reloadPending = false;
+        reloadSlides();
+    }
+}
+
+// Brings slideList in line with newSlides, signalling only the rows that
+// differ so that views keep their delegates for unchanged slides.
+//
+// Rows are matched by blockHash through hash tables, so a reload is close
+// to linear in the number of slides.  Going through the new slides in
+// order, the first old row not yet placed is kept if it matches; if
+// neither it nor the new slide appears again it was edited in place;
+// otherwise a later matching old row is moved up, or the new slide is
+// inserted.  Old rows left over at the end are removed in one step.
+void SlideListModel::updateSlides(
+        const QList<QSharedPointer<SlideData> >& newSlides)
+{
+    const int oldCount = slideList.size();
+    const int newCount = newSlides.size();
+
+    if (oldCount == 0 || newCount == 0) {
+        if (oldCount > 0) {
+            beginRemoveRows(QModelIndex(), 0, oldCount - 1);
+            slideList.clear();
+            removeRoleValues(0, oldCount);
+            endRemoveRows();
+        }
+        if (newCount > 0) {
+            beginInsertRows(QModelIndex(), 0, newCount - 1);
+            slideList = newSlides;
+            insertRoleValues(0, newSlides, 0, newCount);
+            endInsertRows();
+        }
+        return;
+    }
 
-            if (linePtr->contains("[")) {
-                stripSquareBrackets(linePtr,rawSettingsList, lineCount);
-                populateSlideSettings(*rawSettingsList,
-                                         currentSlideSettings);
+    // unchanged slides at either end are left alone
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount &&
+           slideList.at(prefix)->blockHash ==
+           newSlides.at(prefix)->blockHash) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix &&
+           slideList.at(oldCount - 1 - suffix)->blockHash ==
+           newSlides.at(newCount - 1 - suffix)->blockHash) {
+        ++suffix;
+    }
+    const int oldSize = oldCount - suffix - prefix;
+    const int newEnd = newCount - suffix;
+
+    // old rows are numbered from prefix; oldLeft and newLeft count the
+    // hashes of the old rows not yet placed and of the new slides to come
+    QHash<uint, int> oldLeft;
+    QHash<uint, int> newLeft;
+    QHash<uint, QVector<int> > oldRows;
+    oldLeft.reserve(oldSize);
+    oldRows.reserve(oldSize);
+    for (int j = 0; j < oldSize; ++j) {
+        const uint hash = slideList.at(prefix + j)->blockHash;
+        ++oldLeft[hash];
+        oldRows[hash].append(j);
+    }
+    newLeft.reserve(newEnd - prefix);
+    for (int i = prefix; i < newEnd; ++i) {
+        ++newLeft[newSlides.at(i)->blockHash];
+    }
+
+    QVector<SlideEdit> edits;
+    QVector<bool> placed(oldSize, false);
+    UnplacedRows unplaced(oldSize);
+    QHash<uint, int> nextOldRow;
+    int head = 0;
+    int moved = 0;
+    int inserted = 0;
+    int row = prefix;
+    for (int i = prefix; i < newEnd; ++i, ++row) {
+        const uint hash = newSlides.at(i)->blockHash;
+        --newLeft[hash];
+        while (head < oldSize && placed.at(head)) {
+            ++head;
+        }
+        if (head < oldSize) {
+            const uint headHash = slideList.at(prefix + head)->blockHash;
+            if (headHash == hash || (oldLeft.value(hash) == 0 &&
+                                     newLeft.value(headHash) == 0)) {
+                placed[head] = true;
+                unplaced.place(head);
+                --oldLeft[headHash];
+                if (headHash != hash) {
+                    addEdit(edits, SlideEdit::Change, row, i);
+                }
+                continue;
             }
         }
+        if (oldLeft.value(hash) > 0) {
+            const QVector<int>& rows = oldRows[hash];
+            int& next = nextOldRow[hash];
+            while (placed.at(rows.at(next))) {
+                ++next;
+            }
+            const int j = rows.at(next++);
+            SlideEdit move = { SlideEdit::Move, row,
+                               row + unplaced.before(j), i, 1 };
+            edits.append(move);
+            placed[j] = true;
+            unplaced.place(j);
+            --oldLeft[hash];
+            ++moved;
+        }
         else {
-            stripComments(linePtr, currentNotesText, "#");
-            findMaxLineLength(linePtr, lineLength);
-            currentSlideText->append(*linePtr);
+            addEdit(edits, SlideEdit::Insert, row, i);
+            ++inserted;
         }
-        ++lineCount;
     }
-    if (!(currentSlideText->isEmpty())) {
-        *currentSlideText = currentSlideText->trimmed();
-        currentSlideSettings->slideText = *currentSlideText;
-        *currentNotesText = currentNotesText->trimmed();
-        currentSlideSettings->notesText = *currentNotesText;
-        if (lineLength > 0) {
-            currentSlideSettings->maxLineLength = lineLength;
+    const int removed = unplaced.before(oldSize);
+
+    const int changedRows = qMax(oldSize, newEnd - prefix);
+    if (changedRows >= minResetRows &&
+            ((inserted + moved + removed) * 8 > changedRows * 7 ||
+             moved > maxMovedRows)) {
+        beginResetModel();
+        slideList = newSlides;
+        removeRoleValues(0, oldCount);
+        insertRoleValues(0, newSlides, 0, newCount);
+        endResetModel();
+        return;
+    }
+
+    for (int e = 0; e < edits.size(); ++e) {
+        const SlideEdit& edit = edits.at(e);
+        switch (edit.type) {
+        case SlideEdit::Insert:
+            beginInsertRows(QModelIndex(), edit.row,
+                            edit.row + edit.count - 1);
+            slideList = slideList.mid(0, edit.row) +
+                    newSlides.mid(edit.first, edit.count) +
+                    slideList.mid(edit.row);
+            insertRoleValues(edit.row, newSlides, edit.first, edit.count);
+            endInsertRows();
+            break;
+        case SlideEdit::Change:
+            for (int k = 0; k < edit.count; ++k) {
+                slideList[edit.row + k] = newSlides.at(edit.first + k);
+                setRoleValues(edit.row + k, *newSlides.at(edit.first + k));
+            }
+            emit dataChanged(index(edit.row),
+                             index(edit.row + edit.count - 1));
+            break;
+        case SlideEdit::Move:
+            beginMoveRows(QModelIndex(), edit.from, edit.from,
+                          QModelIndex(), edit.row);
+            slideList.move(edit.from, edit.row);
+            moveRoleValues(edit.from, edit.row);
+            endMoveRows();
+            break;
         }
+    }
 
-                // insert("slideText",*currentSlideText);
+    if (removed > 0) {
+        beginRemoveRows(QModelIndex(), newEnd, newEnd + removed - 1);
+        slideList.erase(slideList.begin() + newEnd,
+                        slideList.begin() + newEnd + removed);
+        removeRoleValues(newEnd, removed);
+        endRemoveRows();
     }
-    if (!slideList.isEmpty()) {
-        slideList.pop_front();
+}
+
+// columns hold one prebuilt QVariant per role and row, in slideList order
+void SlideListModel::insertRoleValues(
+        int row, const QList<QSharedPointer<SlideData> >& slides, int first,
+        int count)
+{
+    for (int column = 0; column < SlideRoleCount; ++column) {
+        QVector<QVariant>& values = columns[column];
+        values.insert(row, count, QVariant());
+        for (int i = 0; i < count; ++i) {
+            values[row + i] = roleValue(*slides.at(first + i),
+                                        FirstSlideRole + column);
+        }
     }
+}
 
+void SlideListModel::setRoleValues(int row, const SlideData& slide)
+{
+    for (int column = 0; column < SlideRoleCount; ++column) {
+        columns[column][row] = roleValue(slide, FirstSlideRole + column);
+    }
 }
 
-void SlideListModel::reloadSlides()
+// only the values between the two rows shift
+void SlideListModel::moveRoleValues(int from, int to)
 {
-    this->layoutAboutToBeChanged();  // signal to Qt Quick view
-    this->beginResetModel();
-    slideList.clear();
-    readSlideFile(currentFileName);
-    this->endResetModel();
-    this->layoutChanged();           // signal to Qt Quick view
+    for (int column = 0; column < SlideRoleCount; ++column) {
+        QVector<QVariant>::iterator values = columns[column].begin();
+        if (from > to) {
+            std::rotate(values + to, values + from, values + from + 1);
+        }
+        else {
+            std::rotate(values + from, values + from + 1, values + to + 1);
+        }
+    }
+}
 
+void SlideListModel::removeRoleValues(int row, int count)
+{
+    for (int column = 0; column < SlideRoleCount; ++column) {
+        columns[column].remove(row, count);
+    }
+}
+
+// Parsed slides are never modified, so they may be handed to other threads
+QSharedPointer<SlideData> SlideListModel::slideAt(int row) const
+{
+    if (row < 0 || row >= rowCount()) {
+        return QSharedPointer<SlideData>();
+    }
+    if (lazyDeck) {
+        return lazyRow(row).slide;
+    }
+    return slideList.at(row);
+}
+
+// Only the fitted font sizes change; views ask again for the delegates
+// they have, and each slide is laid out once per size.
+void SlideListModel::setSlideSize(int width, int height)
+{
+    const QSize size(width, height);
+    if (size == slideSize) {
+        return;
+    }
+    slideSize = size;
+    if (rowCount() > 0) {
+        emit dataChanged(index(0), index(rowCount() - 1),
+                         QVector<int>() << FittedFontSizeRole);
+    }
+}
+
+QStringList SlideListModel::mediaFiles() const
+{
+    QStringList media;
+    if (lazyDeck) {
+        return media;
+    }
+    const QVector<QVariant>& column = columns[SlideMediaRole - FirstSlideRole];
+    for (int row = 0; row < column.size(); ++row) {
+        QString slideMedia = column.at(row).toString();
+        if (!slideMedia.isEmpty() && !media.contains(slideMedia)) {
+            media.append(slideMedia);
+        }
+    }
+    return media;
+}
+
+// only the rows showing the file are signalled
+void SlideListModel::mediaChanged(const QString& media)
+{
+    ++mediaRevisions[media];
+    for (int row = 0; row < rowCount(); ++row) {
+        QModelIndex slide = index(row);
+        if (data(slide, SlideMediaRole).toString() == media) {
+            emit dataChanged(slide, slide,
+                             QVector<int>() << MediaRevisionRole);
+        }
+    }
 }
 
 QStringList SlideListModel::getRawSlideData() const
 {
     QStringList rawData;
+    QList<QSharedPointer<SlideData> > slides = slideList;
+    if (lazyDeck) {
+        for (int row = 0; row < lazyDeck->size(); ++row) {
+            slides.append(lazyDeck->slide(row));
+        }
+    }
     QList<QSharedPointer<SlideData> >::const_iterator slideIter =
-            slideList.begin();
+            slides.begin();
     QList<QSharedPointer<SlideData> >::const_iterator endIter =
-            slideList.end();
+            slides.end();
     while (slideIter != endIter) {
-        rawData.append(("stageColor: " + (*slideIter)->stageColor));
-        rawData.append(("font: " + (*slideIter)->font));
-        rawData.append(QString("fontSize: %1").arg((*slideIter)->fontSize));
-        rawData.append(("fontSizeUnit: " + (*slideIter)->fontSizeUnit));
-        rawData.append(("notesFont: " + (*slideIter)->notesFont));
-        rawData.append(("notesFontSize: " + (*slideIter)->stageColor));
-        rawData.append(("textColor: " + (*slideIter)->textColor));
-        rawData.append(("textAlign: " + (*slideIter)->textAlign));
-        rawData.append(("shadingColor: " + (*slideIter)->shadingColor));
+        const SlideStyle& style = (*slideIter)->style();
+        rawData.append(("stageColor: " + style.stageColor.name()));
+        rawData.append(("font: " + style.font));
+        rawData.append(QString("fontSize: %1").arg(style.fontSize));
+        rawData.append(("fontSizeUnit: " + style.fontSizeUnit));
+        rawData.append(("notesFont: " + style.notesFont));
+        rawData.append(("notesFontSize: " + style.stageColor.name()));
+        rawData.append(("textColor: " + style.textColor.name()));
+        rawData.append(("textAlign: " + textAlignName(style.textAlign)));
+        rawData.append(("shadingColor: " + style.shadingColor.name()));
         rawData.append(QString("shadingOpacity: %1").arg(
-                           (*slideIter)->shadingOpacity));
+                           style.shadingOpacity));
         rawData.append(QString("duration: %1").arg(
-                           (*slideIter)->duration));
+                           style.duration));
         rawData.append(QString("command: %1").arg((*slideIter)->command));
         rawData.append(QString("transition: %1").arg(
-                           (*slideIter)->transition));
+                           transitionName(style.transition)));
         rawData.append(QString("cameraFrameRate: %1").arg(
-                           (*slideIter)->cameraFrameRate));
+                           style.cameraFrameRate));
         rawData.append(QString("backgroundScale: %1").arg(
-                           (*slideIter)->backgroundScale));
-        rawData.append(QString("position: %1").arg((*slideIter)->position));
+                           scaleModeName(style.backgroundScale)));
+        rawData.append(QString("position: %1").arg(
+                           positionName(style.position)));
         rawData.append(QString("useMarkup: %1").arg(
-                           (*slideIter)->useMarkup));
+                           style.useMarkup));
         rawData.append(QString("slideText: %1").arg(
                            (*slideIter)->slideText));
         rawData.append(QString("maxLineLength: %1").arg(
@@ -385,7 +1125,7 @@ QStringList SlideListModel::getRawSlideData() const
         rawData.append(QString("slideMedia: %1").arg(
                            (*slideIter)->slideMedia));
         rawData.append(QString("backgroundColor: %1").arg(
-                           (*slideIter)->backgroundColor));
+                           style.backgroundColor.name()));
         rawData.append(QString("notesText: %1").arg(
                            (*slideIter)->notesText));
         rawData.append(QString("slideNumber: %1").arg(
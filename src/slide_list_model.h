@@ -28,17 +28,70 @@
 #include <qvariant.h>
 //#include <qscopedpointer.h>
 #include <qsharedpointer.h>
+#include <qhash.h>
 #include <qmap.h>
+#include <qvector.h>
 #include <qstring.h>
 #include <qstringlist.h>
 #include <qfile.h>
+#include <qfuturewatcher.h>
+#include <qcache.h>
+#include <qdatetime.h>
+#include "slide_file_buffer.h"
+#include "slide_text_fitter.h"
+#include <qsize.h>
 
 
 
 namespace pointy {
 
+class LazySlideDeck;
 class SlideData;
 
+// A parsed slide file.  Built off the GUI thread and never modified once
+// handed to the model.
+struct SlideDeck
+{
+    SlideDeck(): isValid(false) {}
+
+    QList<QSharedPointer<SlideData> > slides;
+    QSharedPointer<LazySlideDeck> lazyDeck;     // set for lazy loads only
+    bool isValid;
+};
+
+// A slide file indexed by its "--" lines only, and a slide is read back
+// from its byte range and parsed each time it is asked for, so memory does
+// not grow with the file.  The file is read, not mapped: an editor
+// truncating or rewriting it in place can not fault a read, and once its
+// size or modification time no longer match the index, slides come back
+// blank until the file is indexed again.
+class LazySlideDeck
+{
+public:
+    LazySlideDeck();
+
+    bool open(const QString& fileName);
+    int size() const;
+    QSharedPointer<SlideData> slide(int row) const;
+
+private:
+    Q_DISABLE_COPY(LazySlideDeck)
+
+    struct Block
+    {
+        qint64 begin;       // byte offsets into the file
+        qint64 end;
+        int firstLine;
+    };
+
+    QString fileName;
+    qint64 fileSize;
+    QDateTime modified;
+    QSharedPointer<SlideData> header;
+    uint headerHash;
+    QVector<Block> blocks;
+};
+
 class SlideListModel: public QAbstractListModel
 {
     Q_OBJECT
@@ -48,8 +101,20 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
     int rowCount(const QModelIndex &parent= QModelIndex()) const;
     void readSlideFile(const QString fileName);
+    void loadSlideFile(const QString& fileName);
+    void setDeckCacheDir(const QString& cacheDir);
+    void setLazyLoading(bool lazy, int cachedSlides = defaultCachedSlides);
+
+    static const int defaultCachedSlides = 256;
     QStringList getRawSlideData() const;
+    QSharedPointer<SlideData> slideAt(int row) const;
+
+    // the window slides are shown in, for FittedFontSizeRole
+    Q_INVOKABLE void setSlideSize(int width, int height);
 
+    // every media file the slides use; empty for lazy decks, which would
+    // have to parse the whole file to know
+    QStringList mediaFiles() const;
 
 
     enum SlideRoles {
@@ -75,26 +140,68 @@ public:
         SlideMediaRole,
         BackgroundColorRole,
         NotesTextRole,
-        SlideNumberRole
+        SlideNumberRole,
+        FittedFontSizeRole,     // depends on the slide size, not a column
+        MediaRevisionRole,      // counts replacements of the media file
+
+        FirstSlideRole = StageColorRole,
+        SlideRoleCount = SlideNumberRole - StageColorRole + 1
     };
 
 public slots:
     void reloadSlides();
+    // the file has been replaced on disk; its slides' MediaRevisionRole
+    // changes, so views load it again
+    void mediaChanged(const QString& media);
+
+signals:
+    // each time the slide file has been read, whether or not it changed
+    void slidesLoaded();
+
+private slots:
+    void slideDeckLoaded();
 
 private:
     Q_DISABLE_COPY(SlideListModel)
 
     QHash<int, QByteArray> roleNames() const;
+    static QHash<int, QByteArray> buildRoleNames();
+    static QVariant roleValue(const SlideData& slide, int role);
 
     QSharedPointer<SlideData> customSlideSettings;
     QList<QSharedPointer<SlideData> > slideList;
+    QVector<QVariant> columns[SlideRoleCount];
+    QSharedPointer<LazySlideDeck> lazyDeck;
+    // a parsed lazy slide, and its role values
+    struct LazyRow
+    {
+        QSharedPointer<SlideData> slide;
+        QVector<QVariant> values;
+    };
+    mutable QCache<int, LazyRow> lazyRows;
+    mutable SlideTextFitter textFitter;
+    QSize slideSize;
+    QHash<QString, int> mediaRevisions;
 
     void populateSlideList(QStringList& listIn,
                            QSharedPointer<SlideData>& slide);
     void newSlideSetting();
     void newSlideSetting(const SlideData& customSlideSettings);
+    void updateSlides(const QList<QSharedPointer<SlideData> >& newSlides);
+    bool loadLazyDeck(const QString& fileName);
+    void setLazyDeck(const QSharedPointer<LazySlideDeck>& deck);
+    LazyRow lazyRow(int row) const;
+    void insertRoleValues(int row,
+                          const QList<QSharedPointer<SlideData> >& slides,
+                          int first, int count);
+    void setRoleValues(int row, const SlideData& slide);
+    void moveRoleValues(int from, int to);
+    void removeRoleValues(int row, int count);
 
     QString currentFileName;
+    QString deckCacheDir;
+    QFutureWatcher<SlideDeck> deckWatcher;
+    bool reloadPending;
 
 
     /**
@@ -132,6 +239,13 @@ void populateSlideSettings(QStringList& listIn,
 
 void findMaxLineLength(QSharedPointer<QByteArray>& lineIn, int& lineLength);
 
+void parseSlideBuffer(const char* data, int size,
+                      QList<QSharedPointer<SlideData> >& slides);
+
+SlideDeck loadSlideDeck(const QString& fileName,
+                        const QString& cacheDir = QString());
+SlideDeck loadLazySlideDeck(const QString& fileName);
+
 
 
 }
@@ -0,0 +1,56 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_media_kind.h"
+#include <qfileinfo.h>
+#include <qset.h>
+
+namespace pointy {
+
+namespace {
+
+QSet<QString> videoSuffixes()
+{
+    QSet<QString> suffixes;
+    suffixes << "avi" << "flv" << "mkv" << "mov" << "mp4" << "mpeg"
+             << "ogv" << "webm";
+    return suffixes;
+}
+
+}   // namespace
+
+MediaKind mediaKind(const QString& media)
+{
+    if (media.isEmpty()) {
+        return NoMedia;
+    }
+    static const QSet<QString> videos = videoSuffixes();
+    const QString suffix = QFileInfo(media).suffix().toLower();
+    if (videos.contains(suffix)) {
+        return VideoMedia;
+    }
+    if (suffix == "gif") {
+        return AnimatedImage;
+    }
+    return StillImage;
+}
+
+}   // namespace pointy
@@ -0,0 +1,43 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_MEDIA_KIND_H
+#define SLIDE_MEDIA_KIND_H
+
+#include <qstring.h>
+
+namespace pointy {
+
+enum MediaKind {
+    NoMedia,
+    StillImage,
+    AnimatedImage,
+    VideoMedia
+};
+
+// Decided by the file name's suffix alone, as PointySlide.qml picks the
+// component that shows the slide's media.
+MediaKind mediaKind(const QString& media);
+
+}   // namespace pointy
+
+#endif // SLIDE_MEDIA_KIND_H
@@ -0,0 +1,82 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_media_watcher.h"
+#include "slide_image_cache.h"
+#include "slide_list_model.h"
+
+namespace pointy {
+
+SlideMediaWatcher::SlideMediaWatcher(SlideListModel* model,
+                                     SlideImageCache* images,
+                                     QObject* parent):
+    QObject(parent), model(model), images(images)
+{
+    // videos are too large to read through on every change
+    watcher.setCompareContents(false);
+    connect(model, SIGNAL(slidesLoaded()), this, SLOT(slidesLoaded()));
+    connect(&watcher, SIGNAL(fileChanged(QString)),
+            this, SLOT(fileChanged(QString)));
+    slidesLoaded();
+}
+
+QStringList SlideMediaWatcher::files() const
+{
+    return watcher.files();
+}
+
+void SlideMediaWatcher::checkFiles()
+{
+    watcher.checkFiles();
+}
+
+// media no longer on any slide stops being watched
+void SlideMediaWatcher::slidesLoaded()
+{
+    QHash<QString, QStringList> names;
+    const QStringList media = model->mediaFiles();
+    for (int i = 0; i < media.size(); ++i) {
+        names[images->filePath(media.at(i))].append(media.at(i));
+    }
+
+    QHash<QString, QStringList>::const_iterator iter =
+            mediaNames.constBegin();
+    for (; iter != mediaNames.constEnd(); ++iter) {
+        if (!names.contains(iter.key())) {
+            watcher.removeFile(iter.key());
+        }
+    }
+    for (iter = names.constBegin(); iter != names.constEnd(); ++iter) {
+        watcher.addFile(iter.key());
+    }
+    mediaNames = names;
+}
+
+void SlideMediaWatcher::fileChanged(const QString& fileName)
+{
+    const QStringList media = mediaNames.value(fileName);
+    for (int i = 0; i < media.size(); ++i) {
+        images->evict(media.at(i));
+        model->mediaChanged(media.at(i));
+    }
+}
+
+}   // namespace pointy
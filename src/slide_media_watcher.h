@@ -0,0 +1,71 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_MEDIA_WATCHER_H
+#define SLIDE_MEDIA_WATCHER_H
+
+#include "slide_file_watcher.h"
+#include <qhash.h>
+#include <qobject.h>
+#include <qstring.h>
+#include <qstringlist.h>
+
+namespace pointy {
+
+class SlideImageCache;
+class SlideListModel;
+
+// Watches the images and videos the deck uses, each time the slide file
+// is loaded.  When one is replaced on disk its decoded images are evicted
+// and the model is told, so only the slides showing it are loaded again.
+// Thumbnails are named after their media's modification time, so the
+// grid picks up the new file by itself.
+class SlideMediaWatcher: public QObject
+{
+    Q_OBJECT
+public:
+    SlideMediaWatcher(SlideListModel* model, SlideImageCache* images,
+                      QObject* parent = 0);
+
+    QStringList files() const;
+
+public slots:
+    // compare every media file now, without waiting for a change notice
+    void checkFiles();
+
+private slots:
+    void slidesLoaded();
+    void fileChanged(const QString& fileName);
+
+private:
+    Q_DISABLE_COPY(SlideMediaWatcher)
+
+    SlideListModel* model;
+    SlideImageCache* images;
+    SlideFileWatcher watcher;
+    // absolute path -> the names slides use for it
+    QHash<QString, QStringList> mediaNames;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_MEDIA_WATCHER_H
@@ -0,0 +1,246 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_residency.h"
+#include "slide_list_model.h"
+#include "slide_image_cache.h"
+#include "slide_media_kind.h"
+#include <qimagereader.h>
+
+namespace pointy {
+
+namespace {
+
+int frameCost(const QSize& size, int frames)
+{
+    if (!size.isValid()) {
+        return 0;
+    }
+    return qMax(1, int(qint64(size.width()) * size.height() * 4 * frames
+                       / 1024));
+}
+
+}   // namespace
+
+SlideResidency::SlideResidency(SlideListModel* model,
+                               SlideImageCache* images, QObject* parent):
+    QObject(parent), model(model), images(images), budgetOverride(0),
+    deckBudget(0), currentRow(0), totalCost(0)
+{
+    connect(model, SIGNAL(modelReset()), this, SLOT(deckChanged()));
+    connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(deckChanged()));
+    connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            this, SLOT(deckChanged()));
+    connect(model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+            this, SLOT(deckChanged()));
+    connect(model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
+            this, SLOT(slidesChanged(QModelIndex,QModelIndex,QVector<int>)));
+    deckChanged();
+}
+
+void SlideResidency::setBudget(int budget)
+{
+    budgetOverride = qMax(0, budget);
+    update();
+}
+
+int SlideResidency::budget() const
+{
+    if (budgetOverride > 0) {
+        return budgetOverride;
+    }
+    return deckBudget > 0 ? deckBudget : defaultBudget;
+}
+
+QVariantList SlideResidency::residentRows() const
+{
+    QVariantList rows;
+    for (int i = 0; i < resident.size(); ++i) {
+        rows.append(resident.at(i));
+    }
+    return rows;
+}
+
+int SlideResidency::residentCost() const
+{
+    return totalCost;
+}
+
+bool SlideResidency::isResident(int row) const
+{
+    return resident.contains(row);
+}
+
+QString SlideResidency::report() const
+{
+    QString text = QString("Media residency: %1 of %2 KiB in %3 slides\n")
+            .arg(totalCost).arg(budget()).arg(resident.size());
+    QList<int> rows = resident;
+    qSort(rows);
+    for (int i = 0; i < rows.size(); ++i) {
+        QString media = model->data(model->index(rows.at(i)),
+                                    SlideListModel::SlideMediaRole)
+                .toString();
+        if (!media.isEmpty()) {
+            text += QString("  slide %1: %2, %3 KiB\n").arg(rows.at(i) + 1)
+                    .arg(media).arg(residentMedia.value(media));
+        }
+    }
+    text += QString("Decoded image cache: %1 KiB").arg(images->cost());
+    return text;
+}
+
+void SlideResidency::setCurrentSlide(int row, int width, int height)
+{
+    currentRow = row;
+    windowSize = QSize(width, height);
+    update();
+}
+
+// the header's settings are inherited by every slide, so the first slide
+// carries the deck's budget
+void SlideResidency::deckChanged()
+{
+    QSharedPointer<SlideData> first = model->slideAt(0);
+    deckBudget = first ? first->style().mediaBudget * 1024 : 0;
+    mediaSizes.clear();         // media may have been replaced
+    update();
+}
+
+// a resize only changes the fitted font sizes, which cost no media; a
+// replaced file may have a new size
+void SlideResidency::slidesChanged(const QModelIndex& topLeft,
+                                   const QModelIndex& bottomRight,
+                                   const QVector<int>& roles)
+{
+    Q_UNUSED(topLeft);
+    Q_UNUSED(bottomRight);
+    if (roles.isEmpty() || roles.contains(SlideListModel::SlideMediaRole) ||
+            roles.contains(SlideListModel::BackgroundScaleRole) ||
+            roles.contains(SlideListModel::MediaRevisionRole)) {
+        deckChanged();
+    }
+}
+
+// Slides are taken nearest first, ahead before behind, and the first one
+// that does not fit ends the search, so resident slides stay contiguous.
+// The current slide is resident whatever its cost.
+void SlideResidency::update()
+{
+    const int limit = budget();
+    images->setBudget(limit);
+
+    QList<int> rows;
+    QHash<QString, int> media;
+    int cost = 0;
+    const int count = model->rowCount();
+    bool full = false;
+    for (int offset = 0; offset <= maxDistance && !full; ++offset) {
+        const int candidates[] = { currentRow + offset, currentRow - offset };
+        for (int i = 0; i < (offset ? 2 : 1) && !full; ++i) {
+            const int row = candidates[i];
+            if (row < 0 || row >= count) {
+                continue;
+            }
+            QModelIndex slide = model->index(row);
+            QString slideMedia = model->data(slide,
+                                             SlideListModel::SlideMediaRole)
+                    .toString();
+            int slideCost = 0;
+            if (!slideMedia.isEmpty() && !media.contains(slideMedia)) {
+                bool unscaled = model->data(
+                            slide, SlideListModel::BackgroundScaleRole)
+                        .toInt() == SlideEnums::Unscaled;
+                slideCost = mediaCost(slideMedia, unscaled);
+            }
+            if (offset > 0 && cost + slideCost > limit) {
+                full = true;
+                break;
+            }
+            rows.append(row);
+            if (!slideMedia.isEmpty() && !media.contains(slideMedia)) {
+                media.insert(slideMedia, slideCost);
+            }
+            cost += slideCost;
+        }
+    }
+
+    QHash<QString, int>::const_iterator iter = residentMedia.constBegin();
+    for (; iter != residentMedia.constEnd(); ++iter) {
+        if (!media.contains(iter.key()) &&
+                mediaKind(iter.key()) == StillImage) {
+            images->evict(iter.key());
+        }
+    }
+
+    if (rows != resident || cost != totalCost) {
+        resident = rows;
+        residentMedia = media;
+        totalCost = cost;
+        emit residencyChanged();
+    }
+    else {
+        residentMedia = media;
+    }
+}
+
+// KiB.  Images are decoded covering the window unless they are smaller;
+// a video's resolution is not known before it is opened, so its buffers
+// are taken to be window sized.
+int SlideResidency::mediaCost(const QString& media, bool unscaled) const
+{
+    switch (mediaKind(media)) {
+    case StillImage: {
+        QSize size = mediaSize(media);
+        if (!unscaled && size.isValid() && !windowSize.isEmpty()) {
+            QSize covering = size.scaled(windowSize,
+                                         Qt::KeepAspectRatioByExpanding);
+            if (covering.width() < size.width()) {
+                size = covering;
+            }
+        }
+        return frameCost(size, 1);
+    }
+    case AnimatedImage:
+        return frameCost(mediaSize(media), gifFrames);
+    case VideoMedia:
+        return frameCost(windowSize, videoFrames);
+    case NoMedia:
+        break;
+    }
+    return 0;
+}
+
+// read from the file's header only, and remembered until the deck changes
+QSize SlideResidency::mediaSize(const QString& media) const
+{
+    QHash<QString, QSize>::const_iterator cached =
+            mediaSizes.constFind(media);
+    if (cached != mediaSizes.constEnd()) {
+        return cached.value();
+    }
+    QSize size = QImageReader(images->filePath(media)).size();
+    mediaSizes.insert(media, size);
+    return size;
+}
+
+}   // namespace pointy
@@ -0,0 +1,110 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_RESIDENCY_H
+#define SLIDE_RESIDENCY_H
+
+#include <qhash.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qset.h>
+#include <qsize.h>
+#include <qstring.h>
+#include <qvariant.h>
+#include <qvector.h>
+
+class QModelIndex;
+
+namespace pointy {
+
+class SlideImageCache;
+class SlideListModel;
+
+// Decides which slides may hold decoded media.  Starting at the current
+// slide and moving outwards, slides are made resident while the estimated
+// cost of their media fits a budget in KiB: decoded images, the frames an
+// AnimatedImage holds, and the buffers of a video pipeline.  Images of
+// slides that drop out are evicted from the SlideImageCache, and views
+// unload the GIFs and videos of slides that are not resident.
+//
+// The budget is the --media-budget option if given, else the deck
+// header's [media-budget=MiB] setting, else defaultBudget.
+class SlideResidency: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantList residentRows READ residentRows
+               NOTIFY residencyChanged)
+    Q_PROPERTY(int residentCost READ residentCost NOTIFY residencyChanged)
+    Q_PROPERTY(int budget READ budget NOTIFY residencyChanged)
+public:
+    SlideResidency(SlideListModel* model, SlideImageCache* images,
+                   QObject* parent = 0);
+
+    static const int defaultBudget = 512 * 1024;    // KiB
+    static const int maxDistance = 4;       // slides either side
+    static const int gifFrames = 2;         // current and next frame
+    static const int videoFrames = 8;       // decoder and sink buffers
+
+    // KiB, overriding the deck's setting; 0 uses the deck's
+    void setBudget(int budget);
+    int budget() const;
+
+    QVariantList residentRows() const;
+    int residentCost() const;               // KiB
+    Q_INVOKABLE bool isResident(int row) const;
+    Q_INVOKABLE QString report() const;
+
+public slots:
+    void setCurrentSlide(int row, int width, int height);
+
+signals:
+    void residencyChanged();
+
+private slots:
+    void deckChanged();
+    void slidesChanged(const QModelIndex& topLeft,
+                       const QModelIndex& bottomRight,
+                       const QVector<int>& roles);
+
+private:
+    Q_DISABLE_COPY(SlideResidency)
+
+    void update();
+    int mediaCost(const QString& media, bool unscaled) const;
+    QSize mediaSize(const QString& media) const;
+
+    SlideListModel* model;
+    SlideImageCache* images;
+    int budgetOverride;
+    int deckBudget;
+    int currentRow;
+    QSize windowSize;
+
+    QList<int> resident;                    // nearest first
+    QHash<QString, int> residentMedia;      // media, KiB
+    int totalCost;
+    mutable QHash<QString, QSize> mediaSizes;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_RESIDENCY_H
@@ -0,0 +1,131 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_text_box.h"
+#include "slide_data.h"
+#include <qabstracttextdocumentlayout.h>
+#include <qfont.h>
+#include <qpainter.h>
+#include <qtextoption.h>
+
+namespace pointy {
+
+SlideTextBox::SlideTextBox(const SlideData& slide, const QSizeF& slideSize,
+                           int fontPixels):
+    padding(qMax(1, fontPixels) / 2.0),
+    textColor(slide.style().textColor),
+    shadingColor(slide.style().shadingColor),
+    shadingOpacity(slide.style().shadingOpacity)
+{
+    if (slide.slideText.isEmpty()) {
+        return;
+    }
+    const SlideStyle& style = slide.style();
+    const qreal margin = 0.02 * slideSize.width();
+
+    QFont font(style.font);
+    font.setPixelSize(qMax(1, fontPixels));
+    document.setDefaultFont(font);
+    document.setDocumentMargin(0);
+    document.setDefaultTextOption(QTextOption(Qt::Alignment(style.textAlign)));
+    if (style.useMarkup && Qt::mightBeRichText(slide.slideText)) {
+        document.setHtml(QString(slide.slideText)
+                         .replace('\n', QLatin1String("<br>")));
+    }
+    else {
+        document.setPlainText(slide.slideText);
+    }
+    document.setTextWidth(qMin(document.idealWidth(),
+                               slideSize.width() - 2 * margin - padding));
+
+    box = QRectF(QPointF(0, 0),
+                 document.size() + QSizeF(padding, padding));
+    QRectF bounds(QPointF(0, 0), slideSize);
+    bounds.adjust(margin, margin, -margin, -margin);
+    QPointF center = bounds.center();
+    if (style.position & SlideEnums::LeftEdge) {
+        center.setX(bounds.left() + box.width() / 2);
+    }
+    else if (style.position & SlideEnums::RightEdge) {
+        center.setX(bounds.right() - box.width() / 2);
+    }
+    if (style.position & SlideEnums::TopEdge) {
+        center.setY(bounds.top() + box.height() / 2);
+    }
+    else if (style.position & SlideEnums::BottomEdge) {
+        center.setY(bounds.bottom() - box.height() / 2);
+    }
+    box.moveCenter(center);
+}
+
+bool SlideTextBox::isEmpty() const
+{
+    return box.isEmpty();
+}
+
+QRectF SlideTextBox::rect() const
+{
+    return box;
+}
+
+QRectF SlideTextBox::textRect() const
+{
+    return box.adjusted(padding / 2, padding / 2, -padding / 2, -padding / 2);
+}
+
+// the painter works in units; the image scales them to its pixels
+QImage SlideTextBox::renderText(qreal devicePixelRatio) const
+{
+    const QSize size = (textRect().size() * devicePixelRatio).toSize();
+    if (size.isEmpty()) {
+        return QImage();
+    }
+    QImage text(size, QImage::Format_ARGB32_Premultiplied);
+    text.setDevicePixelRatio(devicePixelRatio);
+    text.fill(Qt::transparent);
+    QPainter painter(&text);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    drawText(painter);
+    return text;
+}
+
+void SlideTextBox::draw(QPainter& painter) const
+{
+    if (isEmpty()) {
+        return;
+    }
+    painter.save();
+    painter.setOpacity(shadingOpacity);
+    painter.fillRect(box, shadingColor);
+    painter.setOpacity(1.0);
+    painter.translate(textRect().topLeft());
+    drawText(painter);
+    painter.restore();
+}
+
+void SlideTextBox::drawText(QPainter& painter) const
+{
+    QAbstractTextDocumentLayout::PaintContext context;
+    context.palette.setColor(QPalette::Text, textColor);
+    document.documentLayout()->draw(&painter, context);
+}
+
+}   // namespace pointy
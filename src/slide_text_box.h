@@ -0,0 +1,72 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_TEXT_BOX_H
+#define SLIDE_TEXT_BOX_H
+
+#include <qcolor.h>
+#include <qimage.h>
+#include <qrect.h>
+#include <qsize.h>
+#include <qtextdocument.h>
+
+class QPainter;
+
+namespace pointy {
+
+class SlideData;
+
+// A slide's text and the shading behind it, laid out for a slide of the
+// given size: the shading is padded by half the font size, and placed by
+// the slide's position 2% of the slide width in from the edges.  Shared by
+// the slide renderer and the thumbnailer, so both place text alike.
+class SlideTextBox
+{
+public:
+    SlideTextBox(const SlideData& slide, const QSizeF& slideSize,
+                 int fontPixels);
+
+    bool isEmpty() const;
+    QRectF rect() const;        // the shading, in slide coordinates
+    QRectF textRect() const;
+
+    // the text alone, on a transparent image of textRect()'s size, with
+    // devicePixelRatio pixels to the unit
+    QImage renderText(qreal devicePixelRatio = 1.0) const;
+    void draw(QPainter& painter) const;
+
+private:
+    Q_DISABLE_COPY(SlideTextBox)
+
+    void drawText(QPainter& painter) const;
+
+    QTextDocument document;
+    QRectF box;
+    qreal padding;
+    QColor textColor;
+    QColor shadingColor;
+    qreal shadingOpacity;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_TEXT_BOX_H
@@ -0,0 +1,123 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_text_fitter.h"
+#include "slide_data.h"
+#include <qfont.h>
+#include <qfontmetrics.h>
+#include <qstringlist.h>
+#include <qtextdocument.h>
+#include <qtextlayout.h>
+
+namespace pointy {
+
+namespace {
+
+const int referenceSize = 100;      // px the text is first measured at
+const qreal unboundedWidth = 1e6;
+
+// what the Text element shows: markup is dropped, lines are not wrapped
+QStringList textLines(const SlideData& slide)
+{
+    QString text = slide.slideText;
+    if (slide.style().useMarkup && Qt::mightBeRichText(text)) {
+        QTextDocument document;
+        document.setHtml(text);
+        text = document.toPlainText();
+    }
+    return text.split(QLatin1Char('\n'));
+}
+
+// the widest line and the height of all of them
+QSizeF measure(const QStringList& lines, const QFont& font)
+{
+    qreal width = 0;
+    for (int i = 0; i < lines.size(); ++i) {
+        QTextLayout layout(lines.at(i), font);
+        layout.beginLayout();
+        QTextLine line = layout.createLine();
+        if (line.isValid()) {
+            line.setLineWidth(unboundedWidth);
+            width = qMax(width, line.naturalTextWidth());
+        }
+        layout.endLayout();
+    }
+    return QSizeF(width, lines.size() * QFontMetricsF(font).lineSpacing());
+}
+
+}   // namespace
+
+SlideTextFitter::SlideTextFitter(int cachedFits):
+    fits(cachedFits)
+{}
+
+// slides not read from a file have no blockHash, and are not kept
+int SlideTextFitter::pixelSize(const SlideData& slide, const QSize& window)
+{
+    if (slide.blockHash == 0) {
+        return fitPixelSize(slide, window);
+    }
+    const quint64 key = (quint64(slide.blockHash) << 32) |
+            (quint64(window.width() & 0xffff) << 16) |
+            quint64(window.height() & 0xffff);
+    if (const int* cached = fits.object(key)) {
+        return *cached;
+    }
+    const int size = fitPixelSize(slide, window);
+    fits.insert(key, new int(size));
+    return size;
+}
+
+int SlideTextFitter::fitPixelSize(const SlideData& slide, const QSize& window)
+{
+    const int wanted = qMax(1, qRound(slide.style().fontSize));
+    if (window.isEmpty() || slide.slideText.isEmpty()) {
+        return wanted;
+    }
+    // the box is anchored 2% of the window width in from the edges, and
+    // its background is padded by half the font size
+    const qreal margins = 0.04 * window.width();
+    const qreal width = window.width() - margins;
+    const qreal height = window.height() - margins;
+
+    const QStringList lines = textLines(slide);
+    QFont font(slide.style().font);
+    font.setPixelSize(referenceSize);
+    const QSizeF measured = measure(lines, font);
+    const qreal fit = qMin(width / (measured.width() / referenceSize + 0.5),
+                           height / (measured.height() / referenceSize + 0.5));
+    int size = qMax(1, qMin(wanted, int(fit)));
+
+    // hinting makes text only roughly proportional to its size, so check
+    // the estimate and step down until it fits
+    while (size > 1) {
+        font.setPixelSize(size);
+        const QSizeF box = measure(lines, font) +
+                QSizeF(size / 2.0, size / 2.0);
+        if (box.width() <= width && box.height() <= height) {
+            break;
+        }
+        size -= qMax(1, size / 50);
+    }
+    return qMax(1, size);
+}
+
+}   // namespace pointy
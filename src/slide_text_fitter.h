@@ -0,0 +1,57 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_TEXT_FITTER_H
+#define SLIDE_TEXT_FITTER_H
+
+#include <qcache.h>
+#include <qsize.h>
+
+namespace pointy {
+
+class SlideData;
+
+// Finds the largest pixel size, up to the slide's own font size, at which
+// the slide's text fits the text box PointySlide.qml draws in a window of
+// the given size.  Lines are laid out with QTextLayout in the slide's
+// font, so proportional fonts are measured as they are drawn.  Results
+// are kept per slide source (blockHash) and window size, so pixelSize() is
+// for the GUI thread only; fitPixelSize() keeps nothing.
+class SlideTextFitter
+{
+public:
+    explicit SlideTextFitter(int cachedFits = defaultCachedFits);
+
+    static const int defaultCachedFits = 4096;
+
+    int pixelSize(const SlideData& slide, const QSize& window);
+    static int fitPixelSize(const SlideData& slide, const QSize& window);
+
+private:
+    Q_DISABLE_COPY(SlideTextFitter)
+
+    QCache<quint64, int> fits;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_TEXT_FITTER_H
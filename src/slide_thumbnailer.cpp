@@ -0,0 +1,266 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_thumbnailer.h"
+#include "slide_list_model.h"
+#include "slide_image_cache.h"
+#include "slide_media_kind.h"
+#include "slide_text_box.h"
+#include "slide_text_fitter.h"
+#include <qcryptographichash.h>
+#include <qdatastream.h>
+#include <qdatetime.h>
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qimagereader.h>
+#include <qpainter.h>
+#include <qrunnable.h>
+#include <qsavefile.h>
+
+namespace pointy {
+
+namespace {
+
+// the background media, scaled the way PointySlide's Image would
+void drawMedia(QPainter& painter, const SlideData& slide, const QSize& size,
+               int slideWidth, SlideImageCache& images)
+{
+    const QRect bounds(QPoint(0, 0), size);
+    if (mediaKind(slide.slideMedia) == VideoMedia) {
+        painter.fillRect(bounds, Qt::black);
+        return;
+    }
+    // only the size is read here; the pixels come from the shared cache
+    const QSize fullSize = QImageReader(images.filePath(slide.slideMedia))
+            .size();
+    if (!fullSize.isValid()) {
+        return;
+    }
+    QSize scaledSize;
+    switch (slide.style().backgroundScale) {
+    case SlideEnums::Stretch:
+        scaledSize = size;
+        break;
+    case SlideEnums::Fit:
+        scaledSize = fullSize.scaled(size, Qt::KeepAspectRatio);
+        break;
+    case SlideEnums::Fill:
+        scaledSize = fullSize.scaled(size, Qt::KeepAspectRatioByExpanding);
+        break;
+    case SlideEnums::Unscaled:
+        scaledSize = fullSize * size.width() / slideWidth;
+        break;
+    }
+    scaledSize = scaledSize.expandedTo(QSize(1, 1));
+    QImage media = images.image(slide.slideMedia, scaledSize);
+    if (media.isNull()) {
+        return;
+    }
+    QRect target(QPoint(0, 0), scaledSize);
+    target.moveCenter(bounds.center());
+    painter.drawImage(target, media);
+}
+
+// the text and its shading, fitted and laid out the way PointySlide
+// does in a window slideWidth wide
+void drawText(QPainter& painter, const SlideData& slide, const QSize& size,
+              int slideWidth)
+{
+    if (slide.slideText.isEmpty()) {
+        return;
+    }
+    const qreal scale = qreal(size.width()) / slideWidth;
+    const QSize window(slideWidth, qRound(size.height() / scale));
+    const int fontPixels = qMax(1, int(SlideTextFitter::fitPixelSize(
+                                           slide, window) * scale));
+    SlideTextBox(slide, size, fontPixels).draw(painter);
+}
+
+// the PNG text key holding the media modification time drawn with
+const char* const mediaModifiedKey = "MediaModified";
+
+class PruneJob: public QRunnable
+{
+public:
+    PruneJob(const QString& cacheDir, qint64 maxBytes):
+        cacheDir(cacheDir), maxBytes(maxBytes)
+    {}
+
+    void run()
+    {
+        SlideThumbnailer::pruneCache(cacheDir, maxBytes);
+    }
+
+private:
+    QString cacheDir;
+    qint64 maxBytes;
+};
+
+}   // namespace
+
+// a thumbnail already on disk is kept if it was drawn with the media as it
+// is now; otherwise it is drawn again
+class ThumbnailJob: public QRunnable
+{
+public:
+    ThumbnailJob(SlideThumbnailer* thumbnailer, const SlideData& slide,
+                 const QSize& size, int slideWidth, const QString& fileName):
+        thumbnailer(thumbnailer), slide(slide), size(size),
+        slideWidth(slideWidth), fileName(fileName)
+    {}
+
+    void run()
+    {
+        QString mediaModified;
+        if (!slide.slideMedia.isEmpty()) {
+            QFileInfo media(QDir(thumbnailer->mediaDir)
+                            .filePath(slide.slideMedia));
+            mediaModified = QString::number(
+                        media.lastModified().toMSecsSinceEpoch());
+        }
+        bool rendered = false;
+        if (!QFile::exists(fileName) ||
+                QImageReader(fileName, "PNG").text(mediaModifiedKey) !=
+                mediaModified) {
+            QImage thumbnail = SlideThumbnailer::renderSlide(
+                        slide, size, slideWidth, *thumbnailer->images);
+            thumbnail.setText(mediaModifiedKey, mediaModified);
+            QSaveFile file(fileName);
+            rendered = file.open(QIODevice::WriteOnly) &&
+                    thumbnail.save(&file, "PNG") && file.commit();
+            if (!rendered) {
+                qWarning("Can not write thumbnail %s", qPrintable(fileName));
+            }
+        }
+        QMetaObject::invokeMethod(thumbnailer, "thumbnailRendered",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(QString, fileName),
+                                  Q_ARG(bool, rendered));
+    }
+
+private:
+    SlideThumbnailer* thumbnailer;
+    SlideData slide;
+    QSize size;
+    int slideWidth;
+    QString fileName;
+};
+
+SlideThumbnailer::SlideThumbnailer(SlideListModel* model,
+                                   SlideImageCache* images,
+                                   const QString& mediaDir,
+                                   const QString& cacheDir,
+                                   qint64 cacheBytes, QObject* parent):
+    QObject(parent), model(model), images(images), mediaDir(mediaDir),
+    cacheDir(cacheDir)
+{
+    QDir().mkpath(cacheDir);
+    // thumbnails should not hold up slide images
+    workers.setMaxThreadCount(1);
+    // pruned before any thumbnail of this run is checked or drawn, so none
+    // in use is deleted
+    workers.start(new PruneJob(cacheDir, cacheBytes));
+}
+
+SlideThumbnailer::~SlideThumbnailer()
+{
+    workers.waitForDone();
+}
+
+// called from bindings, so the files are left to the worker
+QUrl SlideThumbnailer::thumbnailUrl(int row, int width, int height,
+                                    int slideWidth)
+{
+    QSharedPointer<SlideData> slide = model->slideAt(row);
+    if (!slide || width <= 0 || height <= 0 || slideWidth <= 0) {
+        return QUrl();
+    }
+    const int mediaRevision = model->data(
+                model->index(row), SlideListModel::MediaRevisionRole).toInt();
+    const QSize size(width, height);
+    const QString fileName = QDir(cacheDir).filePath(
+                thumbnailName(*slide, mediaDir, mediaRevision, size,
+                              slideWidth));
+
+    if (!checked.contains(fileName) && !pending.contains(fileName)) {
+        pending.insert(fileName);
+        workers.start(new ThumbnailJob(this, *slide, size, slideWidth,
+                                       fileName));
+    }
+    return QUrl::fromLocalFile(fileName);
+}
+
+QString SlideThumbnailer::thumbnailName(const SlideData& slide,
+                                        const QString& mediaDir,
+                                        int mediaRevision, const QSize& size,
+                                        int slideWidth)
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << QDir(mediaDir).absolutePath() << slide.slideText
+           << slide.maxLineLength << slide.slideMedia << slide.style()
+           << mediaRevision << size << slideWidth;
+    return QString::fromLatin1(QCryptographicHash::hash(
+                                   key, QCryptographicHash::Sha1).toHex())
+            + ".png";
+}
+
+void SlideThumbnailer::pruneCache(const QString& cacheDir, qint64 maxBytes)
+{
+    const QFileInfoList thumbnails = QDir(cacheDir).entryInfoList(
+                QStringList("*.png"), QDir::Files, QDir::Time);
+    qint64 bytes = 0;
+    for (int i = 0; i < thumbnails.size(); ++i) {
+        bytes += thumbnails.at(i).size();
+        if (bytes > maxBytes) {
+            QFile::remove(thumbnails.at(i).filePath());
+        }
+    }
+}
+
+QImage SlideThumbnailer::renderSlide(const SlideData& slide,
+                                     const QSize& size, int slideWidth,
+                                     SlideImageCache& images)
+{
+    QImage thumbnail(size, QImage::Format_ARGB32_Premultiplied);
+    thumbnail.fill(slide.style().backgroundColor);
+    QPainter painter(&thumbnail);
+    painter.setRenderHints(QPainter::Antialiasing |
+                           QPainter::SmoothPixmapTransform);
+    if (!slide.slideMedia.isEmpty()) {
+        drawMedia(painter, slide, size, slideWidth, images);
+    }
+    drawText(painter, slide, size, slideWidth);
+    return thumbnail;
+}
+
+// views showing a thumbnail that was missing or out of date load it again
+void SlideThumbnailer::thumbnailRendered(const QString& fileName,
+                                         bool rendered)
+{
+    pending.remove(fileName);
+    checked.insert(fileName);
+    if (rendered) {
+        emit thumbnailReady(QUrl::fromLocalFile(fileName));
+    }
+}
+
+}   // namespace pointy
@@ -0,0 +1,93 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_THUMBNAILER_H
+#define SLIDE_THUMBNAILER_H
+
+#include "slide_data.h"
+#include <qimage.h>
+#include <qobject.h>
+#include <qset.h>
+#include <qsize.h>
+#include <qstring.h>
+#include <qthreadpool.h>
+#include <qurl.h>
+
+namespace pointy {
+
+class SlideImageCache;
+class SlideListModel;
+
+// Renders small pictures of slides for the grid window with QPainter, on
+// worker threads, and keeps them as PNG files in cacheDir.  A thumbnail is
+// named after a SHA-1 of everything it is drawn from, so edited slides get
+// new thumbnails and decks sharing the cache never share one by accident.
+// The media's modification time is checked on the worker, against the one
+// the thumbnail was drawn with; the oldest thumbnails are deleted when the
+// cache grows past its size cap.
+class SlideThumbnailer: public QObject
+{
+    Q_OBJECT
+public:
+    SlideThumbnailer(SlideListModel* model, SlideImageCache* images,
+                     const QString& mediaDir, const QString& cacheDir,
+                     qint64 cacheBytes = defaultCacheBytes,
+                     QObject* parent = 0);
+    ~SlideThumbnailer();
+
+    // the file the thumbnail is, or will be, written to; thumbnailReady()
+    // is emitted once a missing one has been rendered
+    Q_INVOKABLE QUrl thumbnailUrl(int row, int width, int height,
+                                  int slideWidth);
+
+    static const qint64 defaultCacheBytes = 64 * 1024 * 1024;
+
+    static QString thumbnailName(const SlideData& slide,
+                                 const QString& mediaDir, int mediaRevision,
+                                 const QSize& size, int slideWidth);
+    // deletes the least recently written thumbnails beyond maxBytes
+    static void pruneCache(const QString& cacheDir, qint64 maxBytes);
+
+    static QImage renderSlide(const SlideData& slide, const QSize& size,
+                              int slideWidth, SlideImageCache& images);
+
+signals:
+    void thumbnailReady(const QUrl& url);
+
+private slots:
+    void thumbnailRendered(const QString& fileName, bool rendered);
+
+private:
+    friend class ThumbnailJob;
+
+    SlideListModel* model;
+    SlideImageCache* images;
+    QString mediaDir;
+    QString cacheDir;
+    QSet<QString> pending;
+    QSet<QString> checked;      // found current since the thumbnailer began
+    QThreadPool workers;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_THUMBNAILER_H
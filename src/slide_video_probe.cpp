@@ -0,0 +1,254 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "slide_video_probe.h"
+#include "slide_list_model.h"
+#include "slide_media_kind.h"
+#include <qabstractvideosurface.h>
+#include <qatomic.h>
+#include <qdir.h>
+#include <qmutex.h>
+#include <qvideoframe.h>
+
+namespace pointy {
+
+// Takes copies of the frames the probe's player presents.  Frames may be
+// presented on the backend's own thread, so they are handed back queued,
+// tagged with the probe they belong to.
+class PosterSurface: public QAbstractVideoSurface
+{
+public:
+    explicit PosterSurface(QObject* receiver):
+        receiver(receiver), probeId(0)
+    {}
+
+    void setProbe(int id)
+    {
+        probeId.store(id);
+    }
+
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+            QAbstractVideoBuffer::HandleType type) const
+    {
+        QList<QVideoFrame::PixelFormat> formats;
+        if (type == QAbstractVideoBuffer::NoHandle) {
+            formats << QVideoFrame::Format_RGB32
+                    << QVideoFrame::Format_ARGB32
+                    << QVideoFrame::Format_ARGB32_Premultiplied
+                    << QVideoFrame::Format_RGB24
+                    << QVideoFrame::Format_RGB565;
+        }
+        return formats;
+    }
+
+    bool present(const QVideoFrame& frame)
+    {
+        QVideoFrame mapped(frame);
+        if (!mapped.map(QAbstractVideoBuffer::ReadOnly)) {
+            return false;
+        }
+        QImage::Format format =
+                QVideoFrame::imageFormatFromPixelFormat(mapped.pixelFormat());
+        // the frame's buffer is only valid while mapped
+        QImage image = QImage(mapped.bits(), mapped.width(), mapped.height(),
+                              mapped.bytesPerLine(), format).copy();
+        mapped.unmap();
+        QMetaObject::invokeMethod(receiver, "posterGrabbed",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(int, probeId.load()),
+                                  Q_ARG(QImage, image));
+        return true;
+    }
+
+private:
+    QObject* receiver;
+    QAtomicInt probeId;
+};
+
+SlideVideoProbe::SlideVideoProbe(SlideListModel* model,
+                                 const QString& mediaDir, QObject* parent):
+    QObject(parent), model(model), mediaDir(mediaDir),
+    player(0, QMediaPlayer::VideoSurface), surface(new PosterSurface(this)),
+    probeId(0)
+{
+    player.setMuted(true);
+    player.setVideoOutput(surface.data());
+    timeout.setSingleShot(true);
+    timeout.setInterval(probeTimeout);
+
+    connect(&player, SIGNAL(mediaStatusChanged(QMediaPlayer::MediaStatus)),
+            this, SLOT(mediaStatusChanged(QMediaPlayer::MediaStatus)));
+    connect(&timeout, SIGNAL(timeout()), this, SLOT(probeFailed()));
+    connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(rowsInserted(QModelIndex,int,int)));
+    connect(model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
+            this, SLOT(rowsChanged(QModelIndex,QModelIndex,QVector<int>)));
+}
+
+SlideVideoProbe::~SlideVideoProbe()
+{
+    player.stop();
+    player.setVideoOutput(static_cast<QAbstractVideoSurface*>(0));
+}
+
+QUrl SlideVideoProbe::posterUrl(const QString& media)
+{
+    queue(media);
+    return QUrl("image://posters/" +
+                QString::fromLatin1(QUrl::toPercentEncoding(media)));
+}
+
+int SlideVideoProbe::duration(const QString& media) const
+{
+    QMutexLocker lock(&mutex);
+    return int(videos.value(media).duration);
+}
+
+QImage SlideVideoProbe::poster(const QString& media) const
+{
+    QMutexLocker lock(&mutex);
+    return videos.value(media).poster;
+}
+
+QSize SlideVideoProbe::videoSize(const QString& media) const
+{
+    return poster(media).size();
+}
+
+// Eagerly loaded decks insert their rows, and edits change them.  Lazy
+// decks only reset the model; their videos are probed as they are shown.
+void SlideVideoProbe::rowsInserted(const QModelIndex& parent, int first,
+                                   int last)
+{
+    Q_UNUSED(parent);
+    queueRows(first, last);
+}
+
+// a replaced video is opened again for its new poster and duration
+void SlideVideoProbe::rowsChanged(const QModelIndex& topLeft,
+                                  const QModelIndex& bottomRight,
+                                  const QVector<int>& roles)
+{
+    if (roles.contains(SlideListModel::MediaRevisionRole)) {
+        QMutexLocker lock(&mutex);
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            videos.remove(model->data(model->index(row),
+                                      SlideListModel::SlideMediaRole)
+                          .toString());
+        }
+    }
+    else if (!roles.isEmpty() &&
+             !roles.contains(SlideListModel::SlideMediaRole)) {
+        return;
+    }
+    queueRows(topLeft.row(), bottomRight.row());
+}
+
+void SlideVideoProbe::queueRows(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        queue(model->data(model->index(row), SlideListModel::SlideMediaRole)
+              .toString());
+    }
+}
+
+void SlideVideoProbe::queue(const QString& media)
+{
+    if (mediaKind(media) != VideoMedia || media == probing ||
+            waiting.contains(media)) {
+        return;
+    }
+    {
+        QMutexLocker lock(&mutex);
+        if (videos.contains(media)) {
+            return;
+        }
+    }
+    waiting.append(media);
+    if (probing.isEmpty()) {
+        QTimer::singleShot(0, this, SLOT(probeNext()));
+    }
+}
+
+void SlideVideoProbe::probeNext()
+{
+    if (!probing.isEmpty() || waiting.isEmpty()) {
+        return;
+    }
+    probing = waiting.takeFirst();
+    surface->setProbe(++probeId);
+    timeout.start();
+    player.setMedia(QUrl::fromLocalFile(
+                        QDir::cleanPath(QDir(mediaDir)
+                                        .absoluteFilePath(probing))));
+}
+
+// pausing a loaded player prerolls it, which presents the first frame
+void SlideVideoProbe::mediaStatusChanged(QMediaPlayer::MediaStatus status)
+{
+    if (probing.isEmpty()) {
+        return;
+    }
+    if (status == QMediaPlayer::LoadedMedia) {
+        player.pause();
+    }
+    else if (status == QMediaPlayer::InvalidMedia) {
+        qWarning("Can not open video %s", qPrintable(probing));
+        probeFailed();
+    }
+}
+
+void SlideVideoProbe::posterGrabbed(int probeId, const QImage& frame)
+{
+    // frames left over from an earlier video are dropped
+    if (probing.isEmpty() || probeId != this->probeId || frame.isNull()) {
+        return;
+    }
+    VideoInfo info;
+    info.duration = player.duration() > 0 ? player.duration() : -1;
+    info.poster = frame.convertToFormat(QImage::Format_RGB32);
+    finishProbe(info);
+}
+
+// unreadable videos are remembered too, so they are not probed again
+void SlideVideoProbe::probeFailed()
+{
+    if (!probing.isEmpty()) {
+        finishProbe(VideoInfo());
+    }
+}
+
+void SlideVideoProbe::finishProbe(const VideoInfo& info)
+{
+    timeout.stop();
+    player.stop();
+    player.setMedia(QMediaContent());
+    {
+        QMutexLocker lock(&mutex);
+        videos.insert(probing, info);
+    }
+    QString media = probing;
+    probing.clear();
+    emit probed(media);
+    QTimer::singleShot(0, this, SLOT(probeNext()));
+}
+
+}   // namespace pointy
@@ -0,0 +1,114 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef SLIDE_VIDEO_PROBE_H
+#define SLIDE_VIDEO_PROBE_H
+
+#include <qhash.h>
+#include <qimage.h>
+#include <qmediaplayer.h>
+#include <qmutex.h>
+#include <qobject.h>
+#include <qscopedpointer.h>
+#include <qsize.h>
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qtimer.h>
+#include <qurl.h>
+#include <qvector.h>
+
+class QModelIndex;
+
+namespace pointy {
+
+class PosterSurface;
+class SlideListModel;
+
+// Opens the videos of a slide deck one at a time in a muted, hidden
+// QMediaPlayer, as soon as their slides are loaded, and keeps each one's
+// duration and first frame.  Video slides show the first frame as a poster
+// until they are played, instead of an empty slide.
+class SlideVideoProbe: public QObject
+{
+    Q_OBJECT
+public:
+    SlideVideoProbe(SlideListModel* model, const QString& mediaDir,
+                    QObject* parent = 0);
+    ~SlideVideoProbe();
+
+    static const int probeTimeout = 5000;   // msec
+
+    // "image://posters/<media>", with the name percent-encoded; a video
+    // not yet probed is queued, and probed() is emitted once its poster
+    // is known
+    Q_INVOKABLE QUrl posterUrl(const QString& media);
+    // msec, or -1 if not known
+    Q_INVOKABLE int duration(const QString& media) const;
+
+    // thread safe, for the QML image loader
+    QImage poster(const QString& media) const;
+    QSize videoSize(const QString& media) const;
+
+signals:
+    void probed(const QString& media);
+
+private slots:
+    void rowsInserted(const QModelIndex& parent, int first, int last);
+    void rowsChanged(const QModelIndex& topLeft,
+                     const QModelIndex& bottomRight,
+                     const QVector<int>& roles);
+    void mediaStatusChanged(QMediaPlayer::MediaStatus status);
+    void posterGrabbed(int probeId, const QImage& frame);
+    void probeNext();
+    void probeFailed();
+
+private:
+    Q_DISABLE_COPY(SlideVideoProbe)
+
+    struct VideoInfo
+    {
+        VideoInfo(): duration(-1) {}
+
+        qint64 duration;
+        QImage poster;
+    };
+
+    void queueRows(int first, int last);
+    void queue(const QString& media);
+    void finishProbe(const VideoInfo& info);
+
+    SlideListModel* model;
+    QString mediaDir;
+    QMediaPlayer player;
+    QScopedPointer<PosterSurface> surface;
+    QTimer timeout;
+    QStringList waiting;
+    QString probing;
+    int probeId;
+
+    mutable QMutex mutex;
+    QHash<QString, VideoInfo> videos;
+};
+
+}   // namespace pointy
+
+#endif // SLIDE_VIDEO_PROBE_H
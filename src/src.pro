@@ -4,7 +4,24 @@ SOURCES += \
     slide_list_model.cpp \
     slide_data.cpp \
     pointy_slide_viewer.cpp \
-    pointy_command.cpp
+    pointy_command.cpp \
+    pointy_command_output.cpp \
+    pin_tokenizer.cpp \
+    slide_file_buffer.cpp \
+    slide_deck_cache.cpp \
+    slide_image_cache.cpp \
+    slide_image_provider.cpp \
+    slide_thumbnailer.cpp \
+    slide_video_probe.cpp \
+    slide_residency.cpp \
+    slide_text_fitter.cpp \
+    slide_text_box.cpp \
+    pointy_slide_item.cpp \
+    pointy_incubation_controller.cpp \
+    pointy_startup_profile.cpp \
+    slide_file_watcher.cpp \
+    slide_media_watcher.cpp \
+    slide_media_kind.cpp
 
 
 TEMPLATE = app
@@ -15,19 +32,40 @@ HEADERS += \
     slide_data.h \
     slide_list_model.h \
     pointy_slide_viewer.h \
-    pointy_command.h
+    pointy_command.h \
+    pointy_command_output.h \
+    pin_tokenizer.h \
+    slide_file_buffer.h \
+    slide_deck_cache.h \
+    slide_image_cache.h \
+    slide_image_provider.h \
+    slide_thumbnailer.h \
+    slide_video_probe.h \
+    slide_residency.h \
+    slide_text_fitter.h \
+    slide_text_box.h \
+    pointy_slide_item.h \
+    pointy_incubation_controller.h \
+    pointy_startup_profile.h \
+    slide_file_watcher.h \
+    slide_media_watcher.h \
+    slide_media_kind.h \
+    slide_enums.h
 
 QT += core \
-      qml quick
+      qml quick \
+      concurrent \
+      multimedia
 
 OTHER_FILES += \
-    SlideView.qml
+    qml/SlideView.qml \
+    qml/PointySlide.qml
 
-RESOURCES +=
+RESOURCES += qml.qrc
 
-folder_01.source = qml
-folder_01.target =
-DEPLOYMENTFOLDERS = folder_01
+# compile the QML ahead of time; Qt versions without the Qt Quick
+# Compiler ignore this and load the QML from the resource at runtime
+CONFIG += qtquickcompiler
 
 QML_IMPORT_PATH =
 
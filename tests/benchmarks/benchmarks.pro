@@ -0,0 +1,36 @@
+TEMPLATE = app
+TARGET = pointy_benchmarks
+
+QMAKE_CXXFLAGS += -std=c++11
+
+INCLUDEPATH += . ../../src/
+
+# Run with e.g. "./pointy_benchmarks -o results.csv,csv" for results that
+# can be compared between releases; see main.cpp for the file names.
+
+HEADERS += \
+          ../../src/slide_data.h \
+          ../../src/slide_enums.h \
+          ../../src/slide_list_model.h \
+          ../../src/pin_tokenizer.h \
+          ../../src/slide_file_buffer.h \
+          ../../src/slide_deck_cache.h \
+          ../../src/slide_text_fitter.h \
+    pointy_benchmark_slide_setting.h \
+    pointy_benchmark_parser.h
+
+SOURCES += \
+      ../../src/slide_data.cpp \
+      ../../src/slide_list_model.cpp \
+      ../../src/pin_tokenizer.cpp \
+      ../../src/slide_file_buffer.cpp \
+      ../../src/slide_deck_cache.cpp \
+      ../../src/slide_text_fitter.cpp \
+    main.cpp \
+    pointy_benchmark_slide_setting.cpp \
+    pointy_benchmark_parser.cpp
+
+QT += testlib concurrent
+
+CONFIG += release \
+    warn_on
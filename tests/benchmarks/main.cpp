@@ -0,0 +1,83 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#include "pointy_benchmark_slide_setting.h"
+#include "pointy_benchmark_parser.h"
+
+#include <QtTest/QtTest>
+#include <qdir.h>
+#include <qfileinfo.h>
+
+
+namespace {
+
+// QTest writes every object's results to the same "-o" file, so each
+// benchmark class gets its own: "-o results.csv,csv" writes
+// results-BenchmarkParser.csv, results-BenchmarkSlideSetting.csv, ...
+QStringList benchmarkArguments(int argc, char* argv[],
+                               const QObject& benchmark)
+{
+    QString className = benchmark.metaObject()->className();
+    className = className.mid(className.lastIndexOf(':') + 1);
+
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i) {
+        QString argument = QString::fromLocal8Bit(argv[i]);
+        if (i > 0 && QString::fromLocal8Bit(argv[i - 1]) == "-o") {
+            QString format;
+            int comma = argument.lastIndexOf(',');
+            if (comma != -1) {
+                format = argument.mid(comma);
+                argument.truncate(comma);
+            }
+            if (argument != "-") {
+                QFileInfo info(argument);
+                QString name = info.completeBaseName() + "-" + className;
+                if (!info.suffix().isEmpty()) {
+                    name += "." + info.suffix();
+                }
+                argument = info.dir().filePath(name);
+            }
+            argument += format;
+        }
+        arguments.append(argument);
+    }
+    return arguments;
+}
+
+}   // namespace
+
+int main(int argc, char* argv[])
+{
+    int status = 0;
+
+    pointy::BenchmarkSlideSetting benchmarkSlideSetting;
+    status |= QTest::qExec(&benchmarkSlideSetting,
+                           benchmarkArguments(argc, argv,
+                                              benchmarkSlideSetting));
+
+    pointy::BenchmarkParser benchmarkParser;
+    status |= QTest::qExec(&benchmarkParser,
+                           benchmarkArguments(argc, argv, benchmarkParser));
+
+    return status;
+}
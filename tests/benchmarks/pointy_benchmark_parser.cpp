@@ -0,0 +1,245 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#include "pointy_benchmark_parser.h"
+#include "slide_data.h"
+#include "slide_list_model.h"
+#include <qtemporaryfile.h>
+
+namespace pointy {
+
+struct SyntheticDeck
+{
+    QList<QByteArray> lines;            // each with its newline
+    QList<QStringList> settings;        // bracket contents of each slide
+    QStringList fonts;                  // one font setting per slide
+    QSharedPointer<QTemporaryFile> file;
+};
+
+namespace {
+
+struct DeckShape
+{
+    const char* name;
+    int linesPerSlide;      // including the "--" line
+    int settingsPerSlide;
+    int commentEvery;       // every nth line has a comment, 0 for none
+};
+
+const DeckShape deckShapes[] = {
+    { "sparse", 6, 0, 0 },
+    { "dense", 3, 3, 2 }
+};
+
+const char* const slideSettings[] = {
+    "font=Sans %1px",
+    "text-color=crimson",
+    "top-left",
+    "shading-opacity=0.5",
+    "lightsteelblue",
+    "transition=fade",
+    "unscaled"
+};
+const int slideSettingCount = sizeof(slideSettings) / sizeof(*slideSettings);
+
+QByteArray makeLine(int line, const DeckShape& shape)
+{
+    QByteArray text;
+    if (line % shape.linesPerSlide == 0) {
+        text = "--";
+        for (int i = 0; i < shape.settingsPerSlide; ++i) {
+            QString setting = QString::fromLatin1(
+                        slideSettings[(line + i) % slideSettingCount]);
+            if (setting.contains(QLatin1String("%1"))) {
+                setting = setting.arg(line % 90 + 10);
+            }
+            text += "[" + setting.toUtf8() + "]";
+        }
+    }
+    else {
+        text = "Line " + QByteArray::number(line) +
+                " of a generated slide \\# not a comment";
+    }
+    if (shape.commentEvery && line % shape.commentEvery == 0) {
+        text += " # notes for line " + QByteArray::number(line);
+    }
+    return text + "\n";
+}
+
+}   // namespace
+
+BenchmarkParser::BenchmarkParser()
+{
+}
+
+void BenchmarkParser::addDeckRows()
+{
+    QTest::addColumn<int>("lineCount");
+    QTest::addColumn<int>("shape");
+
+    const int lineCounts[] = { 100, 10000, 1000000 };
+    const char* const lineNames[] = { "100", "10k", "1M" };
+    for (int size = 0; size < 3; ++size) {
+        for (int shape = 0; shape < 2; ++shape) {
+            QByteArray name = QByteArray(lineNames[size]) + " lines, " +
+                    deckShapes[shape].name;
+            QTest::newRow(name.constData()) << lineCounts[size] << shape;
+        }
+    }
+}
+
+// Decks are generated once per row and reused by every benchmark
+const SyntheticDeck& BenchmarkParser::deck(const QString& name,
+                                           int lineCount, int shape)
+{
+    QSharedPointer<SyntheticDeck>& entry = decks[name];
+    if (entry) {
+        return *entry;
+    }
+    entry = QSharedPointer<SyntheticDeck>(new SyntheticDeck);
+    entry->file = QSharedPointer<QTemporaryFile>(new QTemporaryFile);
+    entry->file->open();
+    entry->file->write("#!/usr/bin/env pinpoint\n[fit]\n[font=Sans 50px]\n");
+
+    const DeckShape& deckShape = deckShapes[shape];
+    QSharedPointer<QStringList> settings(new QStringList);
+    for (int line = 0; line < lineCount; ++line) {
+        QByteArray text = makeLine(line, deckShape);
+        entry->file->write(text);
+        entry->lines.append(text);
+        if (line % deckShape.linesPerSlide == 0) {
+            QSharedPointer<QByteArray> slideLine(new QByteArray(text));
+            settings->clear();
+            pointy::stripSquareBrackets(slideLine, settings, line);
+            entry->settings.append(*settings);
+            entry->fonts.append(QString("Sans %1 px").arg(line % 90 + 10));
+        }
+    }
+    entry->file->flush();
+    return *entry;
+}
+
+void BenchmarkParser::stripComments_data()
+{
+    addDeckRows();
+}
+
+void BenchmarkParser::stripComments()
+{
+    QFETCH(int, lineCount);
+    QFETCH(int, shape);
+    const SyntheticDeck& generated = deck(QTest::currentDataTag(),
+                                          lineCount, shape);
+    QBENCHMARK {
+        QSharedPointer<QString> comments(new QString);
+        for (int i = 0; i < generated.lines.size(); ++i) {
+            QSharedPointer<QByteArray> line(
+                        new QByteArray(generated.lines.at(i)));
+            pointy::stripComments(line, comments);
+        }
+    }
+}
+
+void BenchmarkParser::stripSquareBrackets_data()
+{
+    addDeckRows();
+}
+
+void BenchmarkParser::stripSquareBrackets()
+{
+    QFETCH(int, lineCount);
+    QFETCH(int, shape);
+    const SyntheticDeck& generated = deck(QTest::currentDataTag(),
+                                          lineCount, shape);
+    QBENCHMARK {
+        QSharedPointer<QStringList> settings(new QStringList);
+        for (int i = 0; i < generated.lines.size(); ++i) {
+            QSharedPointer<QByteArray> line(
+                        new QByteArray(generated.lines.at(i)));
+            pointy::stripSquareBrackets(line, settings, i);
+        }
+    }
+}
+
+void BenchmarkParser::populateSlideSettings_data()
+{
+    addDeckRows();
+}
+
+void BenchmarkParser::populateSlideSettings()
+{
+    QFETCH(int, lineCount);
+    QFETCH(int, shape);
+    const SyntheticDeck& generated = deck(QTest::currentDataTag(),
+                                          lineCount, shape);
+    QBENCHMARK {
+        for (int i = 0; i < generated.settings.size(); ++i) {
+            QStringList settings = generated.settings.at(i);
+            QSharedPointer<SlideData> slide(new SlideData);
+            pointy::populateSlideSettings(settings, slide);
+        }
+    }
+}
+
+void BenchmarkParser::setFont_data()
+{
+    addDeckRows();
+}
+
+void BenchmarkParser::setFont()
+{
+    QFETCH(int, lineCount);
+    QFETCH(int, shape);
+    const SyntheticDeck& generated = deck(QTest::currentDataTag(),
+                                          lineCount, shape);
+    SlideData slide;
+    QBENCHMARK {
+        for (int i = 0; i < generated.fonts.size(); ++i) {
+            slide.setFont(generated.fonts.at(i));
+        }
+    }
+}
+
+void BenchmarkParser::readSlideFile_data()
+{
+    addDeckRows();
+}
+
+void BenchmarkParser::readSlideFile()
+{
+    QFETCH(int, lineCount);
+    QFETCH(int, shape);
+    const SyntheticDeck& generated = deck(QTest::currentDataTag(),
+                                          lineCount, shape);
+    const QString fileName = generated.file->fileName();
+    QBENCHMARK {
+        SlideListModel model;
+        model.readSlideFile(fileName);
+    }
+}
+
+void BenchmarkParser::cleanupTestCase()
+{
+    decks.clear();
+}
+
+} // namespace pointy
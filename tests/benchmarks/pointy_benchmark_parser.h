@@ -0,0 +1,65 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef POINTY_BENCHMARK_PARSER_H
+#define POINTY_BENCHMARK_PARSER_H
+
+#include <QtTest/QtTest>
+#include <qmap.h>
+#include <qsharedpointer.h>
+
+namespace pointy {
+
+struct SyntheticDeck;
+
+// Times the parser stages on generated decks of 100, 10k and 1M lines,
+// each with a sparse and a dense mix of comments and settings.
+class BenchmarkParser : public QObject
+{
+    Q_OBJECT
+public:
+    BenchmarkParser();
+
+private:
+    const SyntheticDeck& deck(const QString& name, int lineCount,
+                              int shape);
+    static void addDeckRows();
+
+    QMap<QString, QSharedPointer<SyntheticDeck> > decks;
+
+private slots:
+    void stripComments_data();
+    void stripComments();
+    void stripSquareBrackets_data();
+    void stripSquareBrackets();
+    void populateSlideSettings_data();
+    void populateSlideSettings();
+    void setFont_data();
+    void setFont();
+    void readSlideFile_data();
+    void readSlideFile();
+    void cleanupTestCase();
+};
+
+}
+
+#endif // POINTY_BENCHMARK_PARSER_H
@@ -0,0 +1,291 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#include "pointy_benchmark_slide_setting.h"
+#include "slide_data.h"
+#include <qcolor.h>
+#include <qregexp.h>
+
+namespace pointy {
+
+namespace {
+
+// SlideData's fields and setting assignment before styles were shared and
+// settings became table driven
+struct LegacySlideData
+{
+    LegacySlideData():
+        stageColor("black"), font("Sans"), fontSize(60), notesFont("Sans"),
+        notesFontSize("20px"), textColor("white"), textAlign("center"),
+        shadingColor("black"), shadingOpacity(0.66), duration(30),
+        command(), transition("fade"), cameraFrameRate(0),
+        backgroundScale("fill"), position("center"), useMarkup(true),
+        slideMedia(), backgroundColor("white")
+    {}
+
+    QString stageColor;
+    QString font;
+    qreal fontSize;
+    QString notesFont;
+    QString notesFontSize;
+    QString textColor;
+    QString textAlign;
+    QString shadingColor;
+    qreal shadingOpacity;
+    qreal duration;
+    QString command;
+    QString transition;
+    int cameraFrameRate;
+    QString backgroundScale;
+    QString position;
+    bool useMarkup;
+    QString slideMedia;
+    QString backgroundColor;
+};
+
+void legacySetFont(LegacySlideData& slide, const QString& fontString)
+{
+    QString testFont = fontString.toLower().trimmed();
+    if ((QRegExp("(\\w+ \\d+ ?p(x|t))")).exactMatch(testFont)) {
+        int splitIndex = testFont.indexOf(QRegExp(" \\d+ ?[Pp]([Xx]|[Tt])"));
+        slide.font = (testFont.left(splitIndex)).trimmed();
+        int splitUnitIndex = (testFont.mid(splitIndex)).
+                indexOf(QRegExp("p(x|t)"));
+        bool ok;
+        qreal tempSize = (testFont.mid(splitIndex, splitUnitIndex)).trimmed()
+                .toFloat(&ok);
+        if (ok && tempSize > 0) {
+            slide.fontSize = tempSize;
+        }
+    }
+}
+
+void legacySettingAssign(LegacySlideData& slide, const QString& lhs_in,
+                         const QString& rhs_in)
+{
+    QString lhs((lhs_in.toLower()).trimmed());
+    QString rhs(rhs_in.trimmed());
+
+    if (lhs == "stage-color") {
+        if (QColor::isValidColor(rhs)) {
+            slide.stageColor = rhs;
+        }
+    }
+    else if (lhs == "font") {
+        legacySetFont(slide, rhs);
+    }
+    else if (lhs == "notes-font") {
+        slide.notesFont = rhs;
+    }
+    else if (lhs == "notes-font-size") {
+        slide.notesFontSize = rhs;
+    }
+    else if (lhs == "text-color") {
+        if (QColor::isValidColor(rhs)) {
+            slide.textColor = rhs;
+        }
+    }
+    else if (lhs == "text-align") {
+        if (rhs == "left" || rhs == "right" || rhs == "center" ||
+                rhs == "justify" ) {
+            slide.textAlign = rhs;
+        }
+        else {
+            slide.textAlign = "center";
+        }
+    }
+    else if (lhs == "shading-color") {
+        if (QColor::isValidColor(rhs)) {
+            slide.shadingColor = rhs;
+        }
+    }
+    else if (lhs == "shading-opacity") {
+        bool ok;
+        qreal temp = rhs.toFloat(&ok);
+        if (ok && temp >= 0.0 && temp <= 1.0) {
+            slide.shadingOpacity = temp;
+        }
+    }
+    else if (lhs == "duration") {
+        bool ok;
+        qreal temp = rhs.toFloat(&ok);
+        if (ok) {
+            slide.duration = temp;
+        }
+    }
+    else if (lhs == "command") {
+        slide.command = rhs;
+    }
+    else if (lhs == "transition") {
+        slide.transition = rhs;
+    }
+    else if (lhs == "camera-framerate") {
+        bool ok;
+        int temp = rhs.toInt(&ok);
+        if (ok) {
+            slide.cameraFrameRate = temp;
+        }
+    }
+}
+
+void legacySettingAssign(LegacySlideData& slide, const QString& setting)
+{
+    QString input = setting.trimmed();
+
+    if (input.indexOf(".") != -1) {
+        slide.slideMedia = input;
+    }
+    else {
+        QString lowerInput = input.toLower();
+        if (lowerInput.indexOf("markup") != -1) {
+            slide.useMarkup = (lowerInput != "no-markup");
+        }
+        else if ((QRegExp("fill|fit|stretch|unscaled")
+                  .exactMatch(lowerInput))) {
+            slide.backgroundScale = lowerInput;
+        }
+        else if (QRegExp("(top-left|top|top-right|"
+                          "left|center|right|"
+                          "bottom-left|bottom|bottom-right)")
+                 .exactMatch(lowerInput)) {
+            slide.position = lowerInput;
+        }
+        else if (QColor::isValidColor(lowerInput)) {
+            slide.backgroundColor = lowerInput;
+            slide.slideMedia = QString();
+        }
+    }
+}
+
+void addSettingRows()
+{
+    QTest::addColumn<QString>("setting");
+
+    QTest::newRow("font") << "font=Sans 50px";
+    QTest::newRow("stage-color") << "stage-color=red";
+    QTest::newRow("shading-opacity") << "shading-opacity=0.5";
+    QTest::newRow("transition") << "transition=fade";
+    QTest::newRow("camera-framerate") << "camera-framerate=25";
+    QTest::newRow("unknown key") << "colour=red";
+    QTest::newRow("position") << "bottom-right";
+    QTest::newRow("scale") << "unscaled";
+    QTest::newRow("markup") << "no-markup";
+    QTest::newRow("background color") << "lightsteelblue";
+    QTest::newRow("media") << "images/molly.jpeg";
+}
+
+}   // namespace
+
+BenchmarkSlideSetting::BenchmarkSlideSetting()
+{
+}
+
+void BenchmarkSlideSetting::settingAssign_data()
+{
+    addSettingRows();
+}
+
+void BenchmarkSlideSetting::settingAssign()
+{
+    QFETCH(QString, setting);
+    SlideData slide;
+    int equalsIndex = setting.indexOf("=");
+    if (equalsIndex > 0) {
+        QString lhs = setting.left(equalsIndex);
+        QString rhs = setting.mid(equalsIndex + 1);
+        QBENCHMARK {
+            slide.slideSettingAssign(lhs, rhs);
+        }
+    }
+    else {
+        QBENCHMARK {
+            slide.slideSettingAssign(setting);
+        }
+    }
+}
+
+void BenchmarkSlideSetting::legacySettingAssign_data()
+{
+    addSettingRows();
+}
+
+void BenchmarkSlideSetting::legacySettingAssign()
+{
+    QFETCH(QString, setting);
+    LegacySlideData slide;
+    int equalsIndex = setting.indexOf("=");
+    if (equalsIndex > 0) {
+        QString lhs = setting.left(equalsIndex);
+        QString rhs = setting.mid(equalsIndex + 1);
+        QBENCHMARK {
+            pointy::legacySettingAssign(slide, lhs, rhs);
+        }
+    }
+    else {
+        QBENCHMARK {
+            pointy::legacySettingAssign(slide, setting);
+        }
+    }
+}
+
+void BenchmarkSlideSetting::setFont()
+{
+    SlideData slide;
+    QString font("Monospace 100 px");
+    QBENCHMARK {
+        slide.setFont(font);
+    }
+    QCOMPARE(slide.style().font, QString("monospace"));
+}
+
+void BenchmarkSlideSetting::legacySetFont()
+{
+    LegacySlideData slide;
+    QString font("Monospace 100 px");
+    QBENCHMARK {
+        pointy::legacySetFont(slide, font);
+    }
+    QCOMPARE(slide.font, QString("monospace"));
+}
+
+// every slide starts as a copy of the header settings
+void BenchmarkSlideSetting::copySlide()
+{
+    SlideData header;
+    header.slideSettingAssign("font", "Sans 50px");
+    QList<SlideData> slides;
+    QBENCHMARK {
+        slides.append(header);
+    }
+}
+
+void BenchmarkSlideSetting::legacyCopySlide()
+{
+    LegacySlideData header;
+    pointy::legacySettingAssign(header, "font", "Sans 50px");
+    QList<LegacySlideData> slides;
+    QBENCHMARK {
+        slides.append(header);
+    }
+}
+
+} // namespace pointy
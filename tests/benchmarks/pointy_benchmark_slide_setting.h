@@ -0,0 +1,51 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef POINTY_BENCHMARK_SLIDE_SETTING_H
+#define POINTY_BENCHMARK_SLIDE_SETTING_H
+
+#include <QtTest/QtTest>
+
+namespace pointy {
+
+// Times SlideData's setting dispatch against the if/else and QRegExp
+// version it replaced, which is kept here as a baseline.
+class BenchmarkSlideSetting : public QObject
+{
+    Q_OBJECT
+public:
+    BenchmarkSlideSetting();
+
+private slots:
+    void settingAssign_data();
+    void settingAssign();
+    void legacySettingAssign_data();
+    void legacySettingAssign();
+    void setFont();
+    void legacySetFont();
+    void copySlide();
+    void legacyCopySlide();
+};
+
+}
+
+#endif // POINTY_BENCHMARK_SLIDE_SETTING_H
@@ -23,6 +23,12 @@
 #include "pointy_text_parse_tests.h"
 #include "pointy_test_file_read.h"
 #include "pointy_test_slide_setting.h"
+#include "pointy_test_tokenizer.h"
+#include "pointy_test_image_cache.h"
+#include "pointy_test_thumbnailer.h"
+#include "pointy_test_residency.h"
+#include "pointy_test_file_watcher.h"
+#include "pointy_test_command_output.h"
 
 #include <QtTest/QtTest>
 #include <QtQuickTest/quicktest.h>
@@ -45,6 +51,24 @@ int main()
     pointy::TestFileRead testFileRead;
     QTest::qExec(&testFileRead);
 
+    pointy::TestPinTokenizer testPinTokenizer;
+    QTest::qExec(&testPinTokenizer);
+
+    pointy::TestImageCache testImageCache;
+    QTest::qExec(&testImageCache);
+
+    pointy::TestThumbnailer testThumbnailer;
+    QTest::qExec(&testThumbnailer);
+
+    pointy::TestResidency testResidency;
+    QTest::qExec(&testResidency);
+
+    pointy::TestFileWatcher testFileWatcher;
+    QTest::qExec(&testFileWatcher);
+
+    pointy::TestCommandOutput testCommandOutput;
+    QTest::qExec(&testCommandOutput);
+
 
 
 
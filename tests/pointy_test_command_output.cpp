@@ -0,0 +1,121 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "pointy_test_command_output.h"
+#include <qstringlistmodel.h>
+
+namespace pointy {
+
+TestCommandOutput::TestCommandOutput()
+{
+}
+
+void TestCommandOutput::linesAsTheyArrive()
+{
+    CommandOutput output;
+    QSignalSpy inserted(&output, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    output.append("first\nsec");
+    QCOMPARE(output.rowCount(), 1);
+    output.append("ond\r\n");
+    output.append("oops\n", true);
+    QCOMPARE(output.rowCount(), 3);
+    QCOMPARE(inserted.count(), 3);
+    QCOMPARE(output.data(output.index(1), CommandOutput::LineRole)
+             .toString(), QString("second"));
+    QVERIFY(!output.data(output.index(1), CommandOutput::StandardErrorRole)
+            .toBool());
+    QVERIFY(output.data(output.index(2), CommandOutput::StandardErrorRole)
+            .toBool());
+}
+
+void TestCommandOutput::partialLineOnFinish()
+{
+    CommandOutput output;
+    output.append("no newline");
+    QCOMPARE(output.rowCount(), 0);
+    output.finish();
+    QCOMPARE(output.rowCount(), 1);
+    QCOMPARE(output.data(output.index(0), CommandOutput::LineRole)
+             .toString(), QString("no newline"));
+}
+
+// the buffer keeps the newest lines, and views see the oldest removed
+void TestCommandOutput::oldestLinesDropped()
+{
+    CommandOutput output(3);
+    output.append("1\n2\n");
+    QSignalSpy removed(&output, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    output.append("3\n4\n5\n");
+    QCOMPARE(output.rowCount(), 3);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 0);
+    QCOMPARE(removed.at(0).at(2).toInt(), 1);
+    QStringList lines;
+    for (int row = 0; row < output.rowCount(); ++row) {
+        lines << output.data(output.index(row), CommandOutput::LineRole)
+                 .toString();
+    }
+    QCOMPARE(lines, QStringList() << "3" << "4" << "5");
+
+    output.append("6\n7\n8\n9\n");
+    QCOMPARE(output.data(output.index(0), CommandOutput::LineRole)
+             .toString(), QString("7"));
+    QCOMPARE(output.data(output.index(2), CommandOutput::LineRole)
+             .toString(), QString("9"));
+}
+
+void TestCommandOutput::longLinesSplit()
+{
+    CommandOutput output;
+    output.append(QByteArray(CommandOutput::maxLineLength + 10, 'x'));
+    QCOMPARE(output.rowCount(), 1);
+    output.finish();
+    QCOMPARE(output.rowCount(), 2);
+    QCOMPARE(output.data(output.index(1), CommandOutput::LineRole)
+             .toString().size(), 10);
+}
+
+// a slide's output moves with its row as slides are edited, and goes
+// with a removed slide
+void TestCommandOutput::outputsFollowSlides()
+{
+    QStringListModel slides(QStringList() << "a" << "b" << "c" << "d");
+    PointyCommand commands;
+    commands.setSlides(&slides);
+    QObject* b = commands.output(1);
+    QObject* c = commands.output(2);
+    // a refused command writes its output without starting a process
+    commands.runCommand(1, "rm b");
+    QCOMPARE(qobject_cast<CommandOutput*>(b)->rowCount(), 1);
+
+    slides.insertRows(0, 2);
+    QCOMPARE(commands.output(3), b);
+    QCOMPARE(commands.output(4), c);
+
+    slides.removeRows(3, 1);
+    QCOMPARE(commands.output(3), c);
+    QVERIFY(commands.output(4) != b);
+
+    slides.setStringList(QStringList() << "c");
+    QVERIFY(commands.output(0) != c);
+}
+
+}
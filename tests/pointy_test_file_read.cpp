@@ -21,6 +21,8 @@
 
 
 #include "pointy_test_file_read.h"
+#include "../src/slide_file_buffer.h"
+#include "../src/slide_deck_cache.h"
 
 namespace pointy {
 
@@ -38,15 +40,15 @@ void TestFileRead::readSimpleFile()
 //                           " global settings before first slide");
     QStringList data = testModel->getRawSlideData();
     QStringList expectedData = (QStringList() <<
-//                                "stageColor: black" <<
+//                                "stageColor: #000000" <<
 //                                "font: sans" <<
 //                                "fontSize: 50" <<
 //                                "fontSizeUnit: px" <<
 //                                "notesFont: Sans" <<
-//                                "notesFontSize: black" <<
-//                                "textColor: white" <<
+//                                "notesFontSize: #000000" <<
+//                                "textColor: #ffffff" <<
 //                                "textAlign: left" <<
-//                                "shadingColor: black" <<
+//                                "shadingColor: #000000" <<
 //                                "shadingOpacity: 0.66" <<
 //                                "duration: 5.5" <<
 //                                "command: " <<
@@ -58,18 +60,18 @@ void TestFileRead::readSimpleFile()
 //                                "slideText: " <<
 //                                "maxLineLength: 0" <<
 //                                "slideMedia: " <<
-//                                "backgroundColor: white" <<
+//                                "backgroundColor: #ffffff" <<
 //                                "notesText: " <<
 //                                "slideNumber: 0" <<
-                                "stageColor: black" <<
+                                "stageColor: #000000" <<
                                 "font: sans" <<
                                 "fontSize: 50" <<
                                 "fontSizeUnit: px" <<
                                 "notesFont: Sans" <<
-                                "notesFontSize: black" <<
-                                "textColor: white" <<
+                                "notesFontSize: #000000" <<
+                                "textColor: #ffffff" <<
                                 "textAlign: center" <<
-                                "shadingColor: black" <<
+                                "shadingColor: #000000" <<
                                 "shadingOpacity: 0.66" <<
                                 "duration: 5.5" <<
                                 "command: " <<
@@ -81,18 +83,18 @@ void TestFileRead::readSimpleFile()
                                 "slideText: A new slide" <<
                                 "maxLineLength: 11" <<
                                 "slideMedia: " <<
-                                "backgroundColor: white" <<
+                                "backgroundColor: #ffffff" <<
                                 "notesText: An initial slide" <<
                                 "slideNumber: 0" <<
-                                "stageColor: black" <<
+                                "stageColor: #000000" <<
                                 "font: sans" <<
                                 "fontSize: 20" <<
                                 "fontSizeUnit: px" <<
                                 "notesFont: Sans" <<
-                                "notesFontSize: black" <<
-                                "textColor: white" <<
+                                "notesFontSize: #000000" <<
+                                "textColor: #ffffff" <<
                                 "textAlign: center" <<
-                                "shadingColor: black" <<
+                                "shadingColor: #000000" <<
                                 "shadingOpacity: 0.66" <<
                                 "duration: 5.5" <<
                                 "command: " <<
@@ -104,18 +106,18 @@ void TestFileRead::readSimpleFile()
                                 "slideText: A blue slide" <<
                                 "maxLineLength: 12" <<
                                 "slideMedia: " <<
-                                "backgroundColor: lightsteelblue" <<
+                                "backgroundColor: #b0c4de" <<
                                 "notesText: Some colour!" <<
                                 "slideNumber: 0" <<
-                                "stageColor: black" <<
+                                "stageColor: #000000" <<
                                 "font: sans" <<
                                 "fontSize: 50" <<
                                 "fontSizeUnit: px" <<
                                 "notesFont: Sans" <<
-                                "notesFontSize: black" <<
-                                "textColor: white" <<
+                                "notesFontSize: #000000" <<
+                                "textColor: #ffffff" <<
                                 "textAlign: center" <<
-                                "shadingColor: black" <<
+                                "shadingColor: #000000" <<
                                 "shadingOpacity: 0.66" <<
                                 "duration: 5.5" <<
                                 "command: " <<
@@ -127,7 +129,7 @@ void TestFileRead::readSimpleFile()
                          "slideText: A third slide,\nwith a second line!" <<
                                 "maxLineLength: 19" <<
                          "slideMedia: " <<
-                         "backgroundColor: white" <<
+                         "backgroundColor: #ffffff" <<
                          "notesText: a little extra something" <<
                          "slideNumber: 0");
     QStringList::const_iterator dataIter= data.begin();
@@ -146,4 +148,327 @@ void TestFileRead::readSimpleFile()
     QCOMPARE(data,expectedData);
 }
 
+void TestFileRead::readMappedFile()
+{
+    QFile resource(":/test_input_files/simple_file.pin");
+    QVERIFY(resource.open(QIODevice::ReadOnly));
+    QTemporaryFile copy;
+    QVERIFY(copy.open());
+    copy.write(resource.readAll());
+    copy.flush();
+
+    SlideFileBuffer buffer;
+    QVERIFY(buffer.open(copy.fileName()));
+    QVERIFY(buffer.isMapped());
+    QCOMPARE(buffer.size(), int(resource.size()));
+    buffer.close();
+
+    SlideListModel mappedModel;
+    mappedModel.readSlideFile(copy.fileName());
+    QCOMPARE(mappedModel.getRawSlideData(), testModel->getRawSlideData());
+}
+
+void TestFileRead::writeFile(QFile& file, const QByteArray& contents)
+{
+    file.resize(0);
+    file.seek(0);
+    file.write(contents);
+    file.flush();
+}
+
+void TestFileRead::reloadChangedSlide()
+{
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "[fill]\n--\nFirst\n--\nSecond\n--\nThird\n");
+    SlideListModel model;
+    model.readSlideFile(deck.fileName());
+    QCOMPARE(model.rowCount(), 3);
+
+    QSignalSpy changedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    writeFile(deck, "[fill]\n--\nFirst\n--\nSecond, fixed\n--\nThird\n");
+    model.readSlideFile(deck.fileName());
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toModelIndex().row(), 1);
+    QCOMPARE(model.data(model.index(1), SlideListModel::SlideTextRole)
+             .toString(), QString("Second, fixed"));
+}
+
+void TestFileRead::reloadInsertedSlide()
+{
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "--\nFirst\n--\nSecond\n--\nThird\n");
+    SlideListModel model;
+    model.readSlideFile(deck.fileName());
+
+    QSignalSpy changedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy movedSpy(&model,
+            SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    writeFile(deck, "--\nThird\n--\nFirst\n--\nNew\n--\nSecond\n");
+    model.readSlideFile(deck.fileName());
+
+    QCOMPARE(changedSpy.count(), 0);
+    QCOMPARE(movedSpy.count(), 1);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(model.rowCount(), 4);
+    QStringList texts;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        texts.append(model.data(model.index(row),
+                                SlideListModel::SlideTextRole).toString());
+    }
+    QCOMPARE(texts, QStringList() << "Third" << "First" << "New" << "Second");
+}
+
+// neighbouring new slides are inserted in one step
+void TestFileRead::reloadAppendedSlides()
+{
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "--\nFirst\n--\nSecond\n");
+    SlideListModel model;
+    model.readSlideFile(deck.fileName());
+
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    writeFile(deck, "--\nFirst\n--\nSecond\n--\nA\n--\nB\n--\nC\n");
+    model.readSlideFile(deck.fileName());
+
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 2);
+    QCOMPARE(insertedSpy.at(0).at(2).toInt(), 4);
+}
+
+// a header setting changes every slide's hash; the slides are edited in
+// place rather than removed and inserted again
+void TestFileRead::reloadChangedHeader()
+{
+    QByteArray slides;
+    for (int i = 0; i < 200; ++i) {
+        slides.append(QString("--\nSlide %1\n").arg(i).toUtf8());
+    }
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "[font=Sans 40px]\n" + slides);
+    SlideListModel model;
+    model.readSlideFile(deck.fileName());
+
+    QSignalSpy changedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    writeFile(deck, "[font=Sans 50px]\n" + slides);
+    model.readSlideFile(deck.fileName());
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(1).toModelIndex().row(), 199);
+    QCOMPARE(model.data(model.index(199), SlideListModel::FontSizeRole)
+             .toReal(), qreal(50));
+}
+
+// moving nearly every slide resets the views instead
+void TestFileRead::reloadReversedDeck()
+{
+    QByteArray forwards;
+    QByteArray backwards;
+    for (int i = 0; i < 200; ++i) {
+        forwards.append(QString("--\nSlide %1\n").arg(i).toUtf8());
+        backwards.append(QString("--\nSlide %1\n").arg(199 - i).toUtf8());
+    }
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, forwards);
+    SlideListModel model;
+    model.readSlideFile(deck.fileName());
+
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy movedSpy(&model,
+            SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    writeFile(deck, backwards);
+    model.readSlideFile(deck.fileName());
+
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(movedSpy.count(), 0);
+    QCOMPARE(model.data(model.index(0), SlideListModel::SlideTextRole)
+             .toString(), QString("Slide 199"));
+}
+
+void TestFileRead::readLargeDeck()
+{
+    // enough slides for the blocks to be parsed in parallel
+    const int slideCount = 500;
+    QByteArray contents("#!/usr/bin/env pinpoint\n[fit]\n[font=Sans 50px]\n");
+    for (int i = 0; i < slideCount; ++i) {
+        contents.append(QString("--[font=Sans %1px] # note %1\nSlide %1\n")
+                        .arg(i + 1).toUtf8());
+    }
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, contents);
+
+    SlideListModel model;
+    model.readSlideFile(deck.fileName());
+    QCOMPARE(model.rowCount(), slideCount);
+    for (int row = 0; row < slideCount; ++row) {
+        QModelIndex slide = model.index(row);
+        QCOMPARE(model.data(slide, SlideListModel::SlideTextRole).toString(),
+                 QString("Slide %1").arg(row + 1));
+        QCOMPARE(model.data(slide, SlideListModel::NotesTextRole).toString(),
+                 QString("note %1").arg(row + 1));
+        QCOMPARE(model.data(slide, SlideListModel::FontSizeRole).toReal(),
+                 qreal(row + 1));
+        QCOMPARE(model.data(slide, SlideListModel::BackgroundScaleRole)
+                 .toInt(), int(SlideEnums::Fit));
+    }
+}
+
+void TestFileRead::readCachedDeck()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "[fit]\n[text-color=red]\n--[top-left]\nFirst # a note\n"
+                    "--[lightsteelblue]\nSecond\n--\nThird\n");
+
+    SlideListModel parsed;
+    parsed.readSlideFile(deck.fileName());
+
+    // the first read writes the cache, the second is served from it
+    SlideListModel cached;
+    cached.setDeckCacheDir(cacheDir.path());
+    cached.readSlideFile(deck.fileName());
+    SlideDeckCache cache(cacheDir.path());
+    QVERIFY(QFile::exists(cache.cacheFileName(deck.fileName())));
+    SlideListModel reread;
+    reread.setDeckCacheDir(cacheDir.path());
+    reread.readSlideFile(deck.fileName());
+    QCOMPARE(reread.getRawSlideData(), parsed.getRawSlideData());
+
+    // a changed file is parsed again, even within the same mtime second
+    writeFile(deck, "--\nOnly slide\n");
+    reread.readSlideFile(deck.fileName());
+    QCOMPARE(reread.rowCount(), 1);
+    QCOMPARE(reread.data(reread.index(0), SlideListModel::SlideTextRole)
+             .toString(), QString("Only slide"));
+}
+
+// a cache file claiming far more styles than it holds is a miss, and the
+// deck is parsed again
+void TestFileRead::corruptCachedDeck()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "--\nFirst\n--\nSecond\n");
+    SlideListModel cached;
+    cached.setDeckCacheDir(cacheDir.path());
+    cached.readSlideFile(deck.fileName());
+
+    // skip the key, then overwrite the style count and drop the rest
+    QFile cacheFile(SlideDeckCache(cacheDir.path())
+                    .cacheFileName(deck.fileName()));
+    QVERIFY(cacheFile.open(QIODevice::ReadWrite));
+    QDataStream stream(&cacheFile);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version;
+    QString path;
+    qint64 modified, size;
+    QByteArray contentHash;
+    stream >> magic >> version >> path >> modified >> size >> contentHash;
+    QVERIFY(stream.status() == QDataStream::Ok);
+    stream << qint32(0x7fffffff);
+    QVERIFY(cacheFile.resize(cacheFile.pos()));
+    cacheFile.close();
+
+    SlideListModel reread;
+    reread.setDeckCacheDir(cacheDir.path());
+    reread.readSlideFile(deck.fileName());
+    QCOMPARE(reread.rowCount(), 2);
+    QCOMPARE(reread.data(reread.index(1), SlideListModel::SlideTextRole)
+             .toString(), QString("Second"));
+}
+
+void TestFileRead::readLazyDeck()
+{
+    QByteArray contents("[fit]\n[shading-opacity=0.5]\n");
+    for (int i = 0; i < 20; ++i) {
+        contents.append(QString("--[font=Sans %1px] # note %1\nSlide %1\n")
+                        .arg(i + 1).toUtf8());
+    }
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, contents);
+
+    SlideListModel parsed;
+    parsed.readSlideFile(deck.fileName());
+
+    // fewer cached slides than rows, so slides are parsed again after
+    // they have been evicted
+    SlideListModel lazy;
+    lazy.setLazyLoading(true, 4);
+    lazy.readSlideFile(deck.fileName());
+    QCOMPARE(lazy.rowCount(), 20);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int row = 0; row < lazy.rowCount(); ++row) {
+            for (int role = SlideListModel::FirstSlideRole;
+                 role < SlideListModel::FirstSlideRole +
+                 SlideListModel::SlideRoleCount; ++role) {
+                QCOMPARE(lazy.data(lazy.index(row), role),
+                         parsed.data(parsed.index(row), role));
+            }
+        }
+    }
+    QCOMPARE(lazy.getRawSlideData(), parsed.getRawSlideData());
+}
+
+// an editor truncating the file in place leaves the rows indexed before
+// it blank, not failing reads, until the file is indexed again
+void TestFileRead::lazyDeckTruncated()
+{
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "--\nFirst\n--\nSecond\n--\nThird\n");
+    SlideListModel lazy;
+    lazy.setLazyLoading(true, 1);
+    lazy.readSlideFile(deck.fileName());
+    QCOMPARE(lazy.data(lazy.index(2), SlideListModel::SlideTextRole)
+             .toString(), QString("Third"));
+    writeFile(deck, "--\n");
+    QCOMPARE(lazy.rowCount(), 3);
+    QVERIFY(lazy.slideAt(1));
+    QVERIFY(lazy.data(lazy.index(1), SlideListModel::SlideTextRole)
+            .toString().isEmpty());
+    lazy.readSlideFile(deck.fileName());
+    QCOMPARE(lazy.rowCount(), 1);
+}
+
+// slideAt() shares the parsed slide with the role values; a cache too
+// small to hold anything still serves every row
+void TestFileRead::lazyDeckCachedSlides()
+{
+    QTemporaryFile deck;
+    QVERIFY(deck.open());
+    writeFile(deck, "--\nFirst\n--\nSecond\n");
+    SlideListModel lazy;
+    lazy.setLazyLoading(true, 2);
+    lazy.readSlideFile(deck.fileName());
+    QVERIFY(lazy.slideAt(1) == lazy.slideAt(1));
+
+    lazy.setLazyLoading(true, 0);
+    for (int row = 0; row < lazy.rowCount(); ++row) {
+        QVERIFY(!lazy.data(lazy.index(row), SlideListModel::SlideTextRole)
+                .toString().isEmpty());
+        QVERIFY(lazy.slideAt(row));
+    }
+}
+
 } // namespace pointy
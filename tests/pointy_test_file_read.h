@@ -37,9 +37,23 @@ public:
 
 private:
     QSharedPointer<SlideListModel> testModel;
+
+    static void writeFile(QFile& file, const QByteArray& contents);
     
 private slots:
     void readSimpleFile();
+    void readMappedFile();
+    void reloadChangedSlide();
+    void reloadInsertedSlide();
+    void reloadAppendedSlides();
+    void reloadChangedHeader();
+    void reloadReversedDeck();
+    void readLargeDeck();
+    void readCachedDeck();
+    void corruptCachedDeck();
+    void readLazyDeck();
+    void lazyDeckTruncated();
+    void lazyDeckCachedSlides();
 
     
 };
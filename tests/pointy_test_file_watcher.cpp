@@ -0,0 +1,142 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+#include "pointy_test_file_watcher.h"
+
+namespace pointy {
+
+TestFileWatcher::TestFileWatcher()
+{
+}
+
+void TestFileWatcher::writeFile(const QString& fileName,
+                                const QByteArray& contents)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(contents);
+}
+
+void TestFileWatcher::initTestCase()
+{
+    QVERIFY(fileDir.isValid());
+}
+
+void TestFileWatcher::contentHash()
+{
+    QString fileName = fileDir.path() + "/hash.pin";
+    writeFile(fileName, "--\nSlide one\n");
+    QByteArray first = SlideFileWatcher::contentHash(fileName);
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(SlideFileWatcher::contentHash(fileName), first);
+    writeFile(fileName, "--\nSlide two\n");
+    QVERIFY(SlideFileWatcher::contentHash(fileName) != first);
+    QVERIFY(SlideFileWatcher::contentHash(fileDir.path() +
+                                          "/missing.pin").isEmpty());
+}
+
+// an editor saving twice, or touching the file, is not a change
+void TestFileWatcher::sameContentsIgnored()
+{
+    QString fileName = fileDir.path() + "/same.pin";
+    writeFile(fileName, "--\nSlide one\n");
+    SlideFileWatcher watcher;
+    watcher.addFile(fileName);
+    watcher.waitForHashes();
+    QSignalSpy changed(&watcher, SIGNAL(fileChanged(QString)));
+    writeFile(fileName, "--\nSlide one\n");
+    watcher.checkFiles();
+    watcher.waitForHashes();
+    QCOMPARE(changed.count(), 0);
+}
+
+void TestFileWatcher::changedContentsReported()
+{
+    QString fileName = fileDir.path() + "/changed.pin";
+    writeFile(fileName, "--\nSlide one\n");
+    SlideFileWatcher watcher;
+    watcher.addFile(fileName);
+    QSignalSpy changed(&watcher, SIGNAL(fileChanged(QString)));
+    // a new size is reported without waiting for a hash
+    writeFile(fileName, "--\nSlide two, edited\n");
+    watcher.checkFiles();
+    QCOMPARE(changed.count(), 1);
+    watcher.checkFiles();
+    watcher.waitForHashes();
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).toString(),
+             QFileInfo(fileName).absoluteFilePath());
+}
+
+void TestFileWatcher::renamedOverFile()
+{
+    QString fileName = fileDir.path() + "/renamed.pin";
+    writeFile(fileName, "--\nSlide one\n");
+    SlideFileWatcher watcher;
+    watcher.addFile(fileName);
+    QSignalSpy changed(&watcher, SIGNAL(fileChanged(QString)));
+
+    QString saved = fileDir.path() + "/renamed.pin.new";
+    writeFile(saved, "--\nSlide two, saved\n");
+    QVERIFY(QFile::remove(fileName));
+    watcher.checkFiles();
+    QCOMPARE(changed.count(), 0);
+    QVERIFY(QFile::rename(saved, fileName));
+    watcher.checkFiles();
+    QCOMPARE(changed.count(), 1);
+}
+
+// only the slides showing the replaced image are signalled
+void TestFileWatcher::replacedMediaSlides()
+{
+    QImage square(16, 16, QImage::Format_RGB32);
+    square.fill(Qt::blue);
+    QVERIFY(square.save(fileDir.path() + "/first.png"));
+    QVERIFY(square.save(fileDir.path() + "/second.png"));
+    writeFile(fileDir.path() + "/media.pin",
+              "--[first.png]\nOne\n--[second.png]\nTwo\n"
+              "--[first.png]\nThree\n");
+
+    SlideListModel model;
+    model.readSlideFile(fileDir.path() + "/media.pin");
+    SlideImageCache images(fileDir.path());
+    SlideMediaWatcher watcher(&model, &images);
+    QCOMPARE(watcher.files().size(), 2);
+    images.image("first.png", QSize());
+    QVERIFY(images.contains("first.png", QSize()));
+
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QImage larger(32, 32, QImage::Format_RGB32);
+    larger.fill(Qt::red);
+    QVERIFY(larger.save(fileDir.path() + "/first.png"));
+    watcher.checkFiles();
+
+    QCOMPARE(changed.count(), 2);
+    QCOMPARE(changed.at(0).at(0).toModelIndex().row(), 0);
+    QCOMPARE(changed.at(1).at(0).toModelIndex().row(), 2);
+    QCOMPARE(model.data(model.index(0), SlideListModel::MediaRevisionRole)
+             .toInt(), 1);
+    QCOMPARE(model.data(model.index(1), SlideListModel::MediaRevisionRole)
+             .toInt(), 0);
+    QVERIFY(!images.contains("first.png", QSize()));
+}
+
+}
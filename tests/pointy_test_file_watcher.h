@@ -0,0 +1,55 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#ifndef POINTY_TEST_FILE_WATCHER_H
+#define POINTY_TEST_FILE_WATCHER_H
+
+#include <QtTest/QtTest>
+#include "../src/slide_file_watcher.h"
+#include "../src/slide_media_watcher.h"
+#include "../src/slide_list_model.h"
+#include "../src/slide_image_cache.h"
+
+namespace pointy {
+
+class TestFileWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    TestFileWatcher();
+
+private:
+    QTemporaryDir fileDir;
+    void writeFile(const QString& fileName, const QByteArray& contents);
+
+private slots:
+    void initTestCase();
+    void contentHash();
+    void sameContentsIgnored();
+    void changedContentsReported();
+    void renamedOverFile();
+    void replacedMediaSlides();
+};
+
+}
+
+#endif // POINTY_TEST_FILE_WATCHER_H
@@ -0,0 +1,91 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#include "pointy_test_image_cache.h"
+
+namespace pointy {
+
+TestImageCache::TestImageCache()
+{
+}
+
+void TestImageCache::initTestCase()
+{
+    QVERIFY(mediaDir.isValid());
+    QImage photo(1600, 1200, QImage::Format_RGB32);
+    photo.fill(Qt::darkGreen);
+    QVERIFY(photo.save(mediaDir.path() + "/photo.png"));
+    QVERIFY(photo.save(mediaDir.path() + "/other.png"));
+}
+
+void TestImageCache::scaledToWindow()
+{
+    SlideImageCache cache(mediaDir.path());
+    // covers the whole window, keeping the aspect ratio
+    QImage image = cache.image("photo.png", QSize(400, 200));
+    QCOMPARE(image.size(), QSize(400, 300));
+    QVERIFY(cache.contains("photo.png", QSize(400, 200)));
+    QVERIFY(!cache.contains("photo.png", QSize(800, 600)));
+}
+
+void TestImageCache::fullSizeWhenUnscaled()
+{
+    SlideImageCache cache(mediaDir.path());
+    QCOMPARE(cache.image("photo.png", QSize()).size(), QSize(1600, 1200));
+    QVERIFY(cache.contains("photo.png", QSize(0, 0)));
+}
+
+void TestImageCache::prefetchedImage()
+{
+    SlideImageCache cache(mediaDir.path());
+    cache.prefetch("photo.png", QSize(160, 120));
+    // waits for the prefetch rather than decoding a second time
+    QCOMPARE(cache.image("photo.png", QSize(160, 120)).size(),
+             QSize(160, 120));
+    QVERIFY(cache.contains("photo.png", QSize(160, 120)));
+}
+
+void TestImageCache::evictedOverBudget()
+{
+    // room for one 800x600 image, 1875 KiB, but not two
+    SlideImageCache cache(mediaDir.path(), 3000);
+    cache.image("photo.png", QSize(800, 600));
+    cache.image("other.png", QSize(800, 600));
+    QVERIFY(!cache.contains("photo.png", QSize(800, 600)));
+    QVERIFY(cache.contains("other.png", QSize(800, 600)));
+    QVERIFY(cache.cost() <= cache.budget());
+}
+
+void TestImageCache::sharedBetweenPaths()
+{
+    SlideImageCache cache(mediaDir.path());
+    QImage image = cache.image("photo.png", QSize(160, 120));
+    QCOMPARE(image.format(), QImage::Format_RGB32);
+    // the same file, however it is named, is decoded once
+    QVERIFY(cache.contains("./photo.png", QSize(160, 120)));
+    QVERIFY(cache.contains(mediaDir.path() + "/photo.png", QSize(160, 120)));
+    QImage again = cache.image("../" + QDir(mediaDir.path()).dirName() +
+                               "/photo.png", QSize(160, 120));
+    QCOMPARE(again.constBits(), image.constBits());
+}
+
+} // namespace pointy
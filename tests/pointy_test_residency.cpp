@@ -0,0 +1,116 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#include "pointy_test_residency.h"
+
+namespace pointy {
+
+TestResidency::TestResidency()
+{
+}
+
+// five slides, each with its own 64x64 image
+void TestResidency::initTestCase()
+{
+    QVERIFY(mediaDir.isValid());
+    QImage square(64, 64, QImage::Format_RGB32);
+    square.fill(Qt::blue);
+    QFile deck(mediaDir.path() + "/deck.pin");
+    QVERIFY(deck.open(QIODevice::WriteOnly));
+    deck.write("[media-budget=1]\n");
+    for (int i = 0; i < 5; ++i) {
+        QString media = QString("slide%1.png").arg(i);
+        QVERIFY(square.save(mediaDir.path() + "/" + media));
+        deck.write(QString("--[%1]\nSlide %2\n").arg(media).arg(i).toUtf8());
+    }
+}
+
+void TestResidency::budgetFromHeader()
+{
+    SlideListModel model;
+    model.readSlideFile(mediaDir.path() + "/deck.pin");
+    SlideImageCache images(mediaDir.path());
+    SlideResidency residency(&model, &images);
+    QCOMPARE(residency.budget(), 1024);
+    QCOMPARE(images.budget(), 1024);
+    // the command line wins over the header
+    residency.setBudget(2048);
+    QCOMPARE(residency.budget(), 2048);
+}
+
+void TestResidency::nearestSlidesFirst()
+{
+    SlideListModel model;
+    model.readSlideFile(mediaDir.path() + "/deck.pin");
+    SlideImageCache images(mediaDir.path());
+    SlideResidency residency(&model, &images);
+    // a 32x32 window makes each image 4 KiB
+    residency.setBudget(10);
+    residency.setCurrentSlide(2, 32, 32);
+    QCOMPARE(residency.residentRows(), QVariantList() << 2 << 3);
+    QCOMPARE(residency.residentCost(), 8);
+    QVERIFY(residency.isResident(3));
+    QVERIFY(!residency.isResident(1));
+
+    residency.setBudget(12);
+    QCOMPARE(residency.residentRows(), QVariantList() << 2 << 3 << 1);
+}
+
+void TestResidency::currentSlideAlwaysResident()
+{
+    SlideListModel model;
+    model.readSlideFile(mediaDir.path() + "/deck.pin");
+    SlideImageCache images(mediaDir.path());
+    SlideResidency residency(&model, &images);
+    residency.setBudget(1);
+    residency.setCurrentSlide(4, 32, 32);
+    QCOMPARE(residency.residentRows(), QVariantList() << 4);
+}
+
+void TestResidency::evictsDistantImages()
+{
+    SlideListModel model;
+    model.readSlideFile(mediaDir.path() + "/deck.pin");
+    SlideImageCache images(mediaDir.path());
+    SlideResidency residency(&model, &images);
+    residency.setBudget(10);
+    residency.setCurrentSlide(0, 32, 32);
+    images.image("slide0.png", QSize(32, 32));
+    QVERIFY(images.contains("slide0.png", QSize(32, 32)));
+
+    residency.setCurrentSlide(4, 32, 32);
+    QVERIFY(!residency.isResident(0));
+    QVERIFY(!images.contains("slide0.png", QSize(32, 32)));
+}
+
+// only the suffix counts, whatever else the name holds
+void TestResidency::mediaKindBySuffix()
+{
+    QCOMPARE(mediaKind(""), NoMedia);
+    QCOMPARE(mediaKind("intro.MP4"), VideoMedia);
+    QCOMPARE(mediaKind("images/xavi.png"), StillImage);
+    QCOMPARE(mediaKind("gifts.jpeg"), StillImage);
+    QCOMPARE(mediaKind("spinner.gif"), AnimatedImage);
+    QCOMPARE(mediaKind("movies.d/still"), StillImage);
+}
+
+} // namespace pointy
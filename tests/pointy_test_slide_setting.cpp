@@ -33,72 +33,105 @@ TestSlideSetting::TestSlideSetting()
 void TestSlideSetting::setFontTest()
 {
     testSlide->setFont("Monospace 100 px");
-    QCOMPARE(testSlide->font, QString("monospace"));
-    QCOMPARE(testSlide->fontSize, qreal(100));
-    QCOMPARE(testSlide->fontSizeUnit, QString("px"));
+    QCOMPARE(testSlide->style().font, QString("monospace"));
+    QCOMPARE(testSlide->style().fontSize, qreal(100));
+    QCOMPARE(testSlide->style().fontSizeUnit, QString("px"));
 }
 
 void TestSlideSetting::assignSlideSettings()
 {
     testSlide->slideSettingAssign("stage-color "," red");
-    QCOMPARE(testSlide->stageColor, QString("red"));
+    QCOMPARE(testSlide->style().stageColor, QColor("red"));
     testSlide->slideSettingAssign("font", "Sans 50 px");
-    QCOMPARE(testSlide->font, QString("sans"));
-    QCOMPARE(testSlide->fontSize, qreal(50));
-    QCOMPARE(testSlide->fontSizeUnit, QString("px"));
+    QCOMPARE(testSlide->style().font, QString("sans"));
+    QCOMPARE(testSlide->style().fontSize, qreal(50));
+    QCOMPARE(testSlide->style().fontSizeUnit, QString("px"));
     testSlide->slideSettingAssign("notes-font", "Sans ");
-    QCOMPARE(testSlide->notesFont, QString("Sans"));
+    QCOMPARE(testSlide->style().notesFont, QString("Sans"));
     testSlide->slideSettingAssign("notes-font-size","100 px");
-    QCOMPARE(testSlide->notesFontSize, QString("100 px"));
+    QCOMPARE(testSlide->style().notesFontSize, QString("100 px"));
     testSlide->slideSettingAssign("text-color", "crimson");
-    QCOMPARE(testSlide->textColor, QString("crimson"));
+    QCOMPARE(testSlide->style().textColor, QColor("crimson"));
     testSlide->slideSettingAssign("text-align","left");
-    QCOMPARE(testSlide->textAlign, QString("left"));
+    QCOMPARE(testSlide->style().textAlign, SlideEnums::AlignLeft);
     testSlide->slideSettingAssign("shading-color", "red");
-    QCOMPARE(testSlide->shadingColor, QString("red"));
+    QCOMPARE(testSlide->style().shadingColor, QColor("red"));
 
     testSlide->slideSettingAssign("shading-opacity","0.5");
-    QCOMPARE(testSlide->shadingOpacity, qreal(0.5));
+    QCOMPARE(testSlide->style().shadingOpacity, qreal(0.5));
     testSlide->slideSettingAssign("duration","0.1");
-    QCOMPARE(testSlide->duration, float(0.1));
+    QCOMPARE(testSlide->style().duration, float(0.1));
     testSlide->slideSettingAssign("transition", "slide");
-    QCOMPARE(testSlide->transition, QString("slide"));
+    QCOMPARE(testSlide->style().transition,
+             SlideEnums::SlideTransition);
+    testSlide->slideSettingAssign("transition", "wipe");
+    QCOMPARE(testSlide->style().transition, SlideEnums::NoTransition);
     testSlide->slideSettingAssign("camera-framerate","20");
-    QCOMPARE(testSlide->cameraFrameRate, int(20));
+    QCOMPARE(testSlide->style().cameraFrameRate, int(20));
+    testSlide->slideSettingAssign("media-budget", "768");
+    QCOMPARE(testSlide->style().mediaBudget, int(768));
+    testSlide->slideSettingAssign("media-budget", "-1");
+    QCOMPARE(testSlide->style().mediaBudget, int(768));
 
     testSlide->slideSettingAssign("inPictura.jpeg ");
     QCOMPARE(testSlide->slideMedia, QString("inPictura.jpeg"));
     testSlide->slideSettingAssign("no-markup");
-    QCOMPARE(testSlide->useMarkup, false);
+    QCOMPARE(testSlide->style().useMarkup, false);
     testSlide->slideSettingAssign("stretch");
-    QCOMPARE(testSlide->backgroundScale, QString("stretch"));
+    QCOMPARE(testSlide->style().backgroundScale, SlideEnums::Stretch);
 
     testSlide->slideSettingAssign("top-left");
-    QCOMPARE(testSlide->position, QString("top-left"));
+    QCOMPARE(testSlide->style().position, SlideEnums::TopLeft);
     testSlide->slideSettingAssign("top-right");
-    QCOMPARE(testSlide->position, QString("top-right"));
+    QCOMPARE(testSlide->style().position, SlideEnums::TopRight);
     testSlide->slideSettingAssign("top");
-    QCOMPARE(testSlide->position, QString("top"));
+    QCOMPARE(testSlide->style().position, SlideEnums::Top);
     testSlide->slideSettingAssign("left");
-    QCOMPARE(testSlide->position, QString("left"));
+    QCOMPARE(testSlide->style().position, SlideEnums::Left);
     testSlide->slideSettingAssign("right");
-    QCOMPARE(testSlide->position, QString("right"));
+    QCOMPARE(testSlide->style().position, SlideEnums::Right);
     testSlide->slideSettingAssign("center");
-    QCOMPARE(testSlide->position, QString("center"));
+    QCOMPARE(testSlide->style().position, SlideEnums::Center);
     testSlide->slideSettingAssign("bottom-left");
-    QCOMPARE(testSlide->position, QString("bottom-left"));
+    QCOMPARE(testSlide->style().position, SlideEnums::BottomLeft);
     testSlide->slideSettingAssign("bottom");
-    QCOMPARE(testSlide->position, QString("bottom"));
+    QCOMPARE(testSlide->style().position, SlideEnums::Bottom);
     testSlide->slideSettingAssign("bottom-right");
-    QCOMPARE(testSlide->position, QString("bottom-right"));
+    QCOMPARE(testSlide->style().position, SlideEnums::BottomRight);
     testSlide->slideSettingAssign("zebra");
-    QCOMPARE(testSlide->backgroundColor, QString("white"));
+    QCOMPARE(testSlide->style().backgroundColor, QColor("white"));
     testSlide->slideSettingAssign("lightsteelblue");
-    QCOMPARE(testSlide->backgroundColor, QString("lightsteelblue"));
+    QCOMPARE(testSlide->style().backgroundColor, QColor("lightsteelblue"));
 
 
 
 }
 
+void TestSlideSetting::shareSlideStyles()
+{
+    SlideData header;
+    header.slideSettingAssign("font", "Sans 50 px");
+
+    // copies share the header's style until they override a setting
+    SlideData plain(header);
+    SlideData blue(header);
+    SlideData alsoBlue(header);
+    QVERIFY(&plain.style() == &header.style());
+    blue.slideSettingAssign("text-color", "blue");
+    alsoBlue.slideSettingAssign("text-color", "blue");
+    QVERIFY(&blue.style() != &header.style());
+    QCOMPARE(plain.style().textColor, QColor("white"));
+
+    SlideStylePool pool;
+    pool.intern(header);
+    pool.intern(plain);
+    pool.intern(blue);
+    pool.intern(alsoBlue);
+    QCOMPARE(pool.size(), 2);
+    QVERIFY(&plain.style() == &header.style());
+    QVERIFY(&alsoBlue.style() == &blue.style());
+    QCOMPARE(alsoBlue.style().textColor, QColor("blue"));
+}
+
 
 } // namespace pointy
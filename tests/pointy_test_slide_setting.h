@@ -41,6 +41,7 @@ private:
 private slots:
     void setFontTest();
     void assignSlideSettings();
+    void shareSlideStyles();
 };
 
 }
@@ -0,0 +1,118 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#include "pointy_test_thumbnailer.h"
+
+namespace pointy {
+
+TestThumbnailer::TestThumbnailer()
+{
+}
+
+void TestThumbnailer::initTestCase()
+{
+    QVERIFY(mediaDir.isValid());
+    QImage wide(200, 100, QImage::Format_RGB32);
+    wide.fill(Qt::red);
+    QVERIFY(wide.save(mediaDir.path() + "/wide.png"));
+}
+
+void TestThumbnailer::backgroundColor()
+{
+    SlideImageCache images(mediaDir.path());
+    SlideData slide;
+    slide.slideSettingAssign("lightsteelblue");
+    QImage thumbnail = SlideThumbnailer::renderSlide(slide, QSize(64, 36),
+                                                     1024, images);
+    QCOMPARE(thumbnail.size(), QSize(64, 36));
+    QCOMPARE(QColor(thumbnail.pixel(32, 18)), QColor("lightsteelblue"));
+}
+
+void TestThumbnailer::fittedMedia()
+{
+    SlideImageCache images(mediaDir.path());
+    SlideData slide;
+    slide.slideSettingAssign("wide.png");
+    slide.slideSettingAssign("fit");
+    QImage thumbnail = SlideThumbnailer::renderSlide(slide, QSize(100, 100),
+                                                     1024, images);
+    // letterboxed: the background shows above and below the image
+    QCOMPARE(QColor(thumbnail.pixel(50, 50)), QColor(Qt::red));
+    QCOMPARE(QColor(thumbnail.pixel(50, 5)), QColor(Qt::white));
+    QCOMPARE(QColor(thumbnail.pixel(50, 95)), QColor(Qt::white));
+}
+
+void TestThumbnailer::filledMedia()
+{
+    SlideImageCache images(mediaDir.path());
+    SlideData slide;
+    slide.slideSettingAssign("wide.png");
+    QImage thumbnail = SlideThumbnailer::renderSlide(slide, QSize(100, 100),
+                                                     1024, images);
+    QCOMPARE(QColor(thumbnail.pixel(50, 5)), QColor(Qt::red));
+    QCOMPARE(QColor(thumbnail.pixel(50, 95)), QColor(Qt::red));
+}
+
+// names differ with anything the thumbnail is drawn from, including the
+// directory its media comes from
+void TestThumbnailer::thumbnailNames()
+{
+    SlideData slide;
+    slide.slideText = "Title";
+    slide.slideSettingAssign("wide.png");
+    const QString name = SlideThumbnailer::thumbnailName(
+                slide, mediaDir.path(), 0, QSize(64, 36), 1024);
+    QCOMPARE(name.size(), 44);
+    QCOMPARE(SlideThumbnailer::thumbnailName(
+                 slide, mediaDir.path(), 0, QSize(64, 36), 1024), name);
+    QVERIFY(SlideThumbnailer::thumbnailName(
+                slide, mediaDir.path() + "/other", 0, QSize(64, 36), 1024)
+            != name);
+    QVERIFY(SlideThumbnailer::thumbnailName(
+                slide, mediaDir.path(), 1, QSize(64, 36), 1024) != name);
+    slide.slideText = "Title.";
+    QVERIFY(SlideThumbnailer::thumbnailName(
+                slide, mediaDir.path(), 0, QSize(64, 36), 1024) != name);
+}
+
+// the newest thumbnails are kept up to the size cap
+void TestThumbnailer::cachePruned()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    QStringList names = QStringList() << "old.png" << "middle.png"
+                                      << "new.png";
+    for (int i = 0; i < names.size(); ++i) {
+        QFile file(cacheDir.path() + "/" + names.at(i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(100, 'x'));
+        file.close();
+        QTest::qSleep(20);
+    }
+    SlideThumbnailer::pruneCache(cacheDir.path(), 250);
+    QDir dir(cacheDir.path());
+    QVERIFY(!dir.exists("old.png"));
+    QVERIFY(dir.exists("middle.png"));
+    QVERIFY(dir.exists("new.png"));
+}
+
+} // namespace pointy
@@ -0,0 +1,119 @@
+/*  
+ *  This file is part of Pointy.
+ *
+ *  Copyright (C) 2013 Michael O'Sullivan 
+ *
+ *  Pointy is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Pointy is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Pointy.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Written by: Michael O'Sullivan
+ */
+
+
+#include "pointy_test_tokenizer.h"
+
+namespace pointy {
+
+TestPinTokenizer::TestPinTokenizer()
+{
+}
+
+QList<PinToken> TestPinTokenizer::tokenize(const QByteArray& input)
+{
+    QList<PinToken> tokens;
+    PinTokenizer tokenizer(input.constData(), input.size());
+    PinToken token;
+    while (tokenizer.next(token)) {
+        tokens.append(token);
+    }
+    return tokens;
+}
+
+void TestPinTokenizer::headerSettings()
+{
+    QByteArray input("[fill][font=Sans 50px] # header\n");
+    QList<PinToken> tokens = tokenize(input);
+    QCOMPARE(tokens.size(), 4);
+    QCOMPARE(int(tokens[0].type), int(PinToken::Setting));
+    QCOMPARE(tokens[0].toString(), QString("fill"));
+    QCOMPARE(tokens[1].toString(), QString("font=Sans 50px"));
+    QCOMPARE(int(tokens[2].type), int(PinToken::Comment));
+    QCOMPARE(tokens[2].toString(), QString(" header\n"));
+    QCOMPARE(int(tokens[3].type), int(PinToken::LineEnd));
+}
+
+void TestPinTokenizer::slideLine()
+{
+    QByteArray input("--[fit]\nA new slide\n");
+    QList<PinToken> tokens = tokenize(input);
+    QCOMPARE(tokens.size(), 5);
+    QCOMPARE(int(tokens[0].type), int(PinToken::SlideStart));
+    QCOMPARE(tokens[1].toString(), QString("fit"));
+    QCOMPARE(int(tokens[2].type), int(PinToken::LineEnd));
+    QCOMPARE(int(tokens[3].type), int(PinToken::Text));
+    QCOMPARE(tokens[3].toString(), QString("A new slide\n"));
+    QCOMPARE(tokens[3].lineNumber, 1);
+    // the token is a view into the input buffer
+    QVERIFY(tokens[3].begin == input.constData() + 8);
+}
+
+void TestPinTokenizer::escapedComment()
+{
+    QByteArray input("Hello \\#and \\#and #goodbye");
+    QList<PinToken> tokens = tokenize(input);
+    QByteArray text;
+    QString notes;
+    foreach (const PinToken& token, tokens) {
+        if (token.type == PinToken::Text) {
+            text.append(token.toByteArray());
+        }
+        else if (token.type == PinToken::Comment) {
+            notes.append(token.toString());
+        }
+    }
+    QCOMPARE(text, QByteArray("Hello #and #and "));
+    QCOMPARE(notes, QString("goodbye"));
+
+    tokens = tokenize("--[command=echo \\#1] # note\n");
+    QCOMPARE(tokens[1].toString(), QString("command=echo #1"));
+}
+
+void TestPinTokenizer::bracketsInSlideText()
+{
+    QList<PinToken> tokens = tokenize("--\n[top-left] [top]\n");
+    QCOMPARE(tokens.size(), 4);
+    QCOMPARE(int(tokens[2].type), int(PinToken::Text));
+    QCOMPARE(tokens[2].toString(), QString("[top-left] [top]\n"));
+}
+
+void TestPinTokenizer::incompleteBrackets()
+{
+    QTest::ignoreMessage(QtWarningMsg, "Line 0: incomplete brackets");
+    QList<PinToken> tokens = tokenize("[first setting]junk[second setting\n");
+    QCOMPARE(tokens.size(), 1);
+    QCOMPARE(int(tokens[0].type), int(PinToken::LineEnd));
+
+    QTest::ignoreMessage(QtWarningMsg, "Line 0: mismatched brackets");
+    tokens = tokenize("--]a[\n");
+    QCOMPARE(tokens.size(), 2);
+}
+
+void TestPinTokenizer::shebangSkipped()
+{
+    QList<PinToken> tokens = tokenize("#!/usr/bin/env pinpoint\n[fill]\n");
+    QCOMPARE(tokens.size(), 2);
+    QCOMPARE(tokens[0].toString(), QString("fill"));
+    QCOMPARE(tokens[0].lineNumber, 0);
+}
+
+} // namespace pointy
@@ -8,21 +8,60 @@ INCLUDEPATH += . ../src/
 HEADERS += \
           ../src/slide_list_model.h \
           ../src/slide_data.h \
+          ../src/pin_tokenizer.h \
+          ../src/slide_file_buffer.h \
+          ../src/slide_deck_cache.h \
+          ../src/slide_enums.h \
+          ../src/slide_image_cache.h \
+          ../src/slide_thumbnailer.h \
+          ../src/slide_residency.h \
+          ../src/slide_text_fitter.h \
+          ../src/slide_text_box.h \
+          ../src/slide_file_watcher.h \
+          ../src/slide_media_watcher.h \
+          ../src/slide_media_kind.h \
+          ../src/pointy_command_output.h \
+          ../src/pointy_command.h \
     pointy_text_parse_tests.h \
     pointy_test_file_read.h \
-    pointy_test_slide_setting.h
+    pointy_test_slide_setting.h \
+    pointy_test_tokenizer.h \
+    pointy_test_image_cache.h \
+    pointy_test_thumbnailer.h \
+    pointy_test_residency.h \
+    pointy_test_file_watcher.h \
+    pointy_test_command_output.h
 
 SOURCES += \
       ../src/slide_list_model.cpp \
       ../src/slide_data.cpp \
+      ../src/pin_tokenizer.cpp \
+      ../src/slide_file_buffer.cpp \
+      ../src/slide_deck_cache.cpp \
+      ../src/slide_image_cache.cpp \
+      ../src/slide_thumbnailer.cpp \
+      ../src/slide_residency.cpp \
+      ../src/slide_text_fitter.cpp \
+      ../src/slide_text_box.cpp \
+      ../src/slide_file_watcher.cpp \
+      ../src/slide_media_watcher.cpp \
+      ../src/slide_media_kind.cpp \
+      ../src/pointy_command_output.cpp \
+      ../src/pointy_command.cpp \
     main.cpp \
     pointy_text_parse_tests.cpp \
     pointy_test_file_read.cpp \
-    pointy_test_slide_setting.cpp
+    pointy_test_slide_setting.cpp \
+    pointy_test_tokenizer.cpp \
+    pointy_test_image_cache.cpp \
+    pointy_test_thumbnailer.cpp \
+    pointy_test_residency.cpp \
+    pointy_test_file_watcher.cpp \
+    pointy_test_command_output.cpp
 
 
 
-QT += testlib
+QT += testlib concurrent
 
 CONFIG += debug \
     warn_on qmltestcase